@@ -1,8 +1,16 @@
 #include "ast_view.hpp"
+#include "compiler.hpp"
 #include "evaluator.hpp"
+#include "inline_cache.hpp"
 #include "lexer.hpp"
+#include "optimizer.hpp"
 #include "parser.hpp"
+#include "profile.hpp"
 #include "repl.hpp"
+#include "source_file.hpp"
+#include "vm.hpp"
+#include <charconv>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -26,21 +34,94 @@ void help() {
   std::cout << "    -p INPUT     Generate parser output" << std::endl;
   std::cout << "    -l INPUT     Generate lexer output" << std::endl;
   std::cout << "    -i INPUT     Generate interpreter output" << std::endl;
+  std::cout << "    --engine=ENGINE  Interpreter engine: tree (default) or vm"
+            << std::endl;
+  std::cout << "    -O           Optimize the tree before -p or -i" << std::endl;
+  std::cout << "    --stream     Run -i one top-level statement at a time, "
+            << "as it is parsed, in bounded memory, pipes included"
+            << std::endl;
+  std::cout << "    --stats      Print inline cache counters after -i"
+            << std::endl;
+  std::cout << "    --profile[=FILE]  Print a flat profile of -i with the tree"
+            << std::endl
+            << "                 engine, write folded stacks to FILE "
+            << "(default profile.folded)" << std::endl;
+  std::cout << "    --overflow=POLICY  Result of integer arithmetic out of "
+            << "64 bits: trap, wrap or promote (default) to a big int"
+            << std::endl;
+  std::cout << "    --recursion-limit=N  Maximum depth of calls (default "
+            << pheonix::context::DEFAULT_RECURSION_LIMIT << ")" << std::endl;
 }
 
+enum class Engine { TREE, VM };
+
 int main(int argc, char **argv) {
+  Engine engine = Engine::TREE;
+  bool optimize = false;
+  bool stats = false;
+  bool stream = false;
+  std::string profile;
+  size_t recursionLimit = pheonix::context::DEFAULT_RECURSION_LIMIT;
+  std::vector<std::string> args;
+  for (int i = 0; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "--engine=tree") {
+      engine = Engine::TREE;
+    } else if (arg == "--engine=vm") {
+      engine = Engine::VM;
+    } else if (arg.starts_with("--engine=")) {
+      std::cerr << "Error: Unknown engine.\n";
+      return 1;
+    } else if (arg == "-O") {
+      optimize = true;
+    } else if (arg == "--stream") {
+      stream = true;
+    } else if (arg == "--stats") {
+      stats = true;
+    } else if (arg == "--profile") {
+      profile = "profile.folded";
+    } else if (arg.starts_with("--profile=")) {
+      profile = arg.substr(arg.find('=') + 1);
+    } else if (arg == "--overflow=trap") {
+      pheonix::types::setOverflowPolicy(pheonix::types::OverflowPolicy::TRAP);
+    } else if (arg == "--overflow=wrap") {
+      pheonix::types::setOverflowPolicy(pheonix::types::OverflowPolicy::WRAP);
+    } else if (arg == "--overflow=promote") {
+      pheonix::types::setOverflowPolicy(
+          pheonix::types::OverflowPolicy::PROMOTE);
+    } else if (arg.starts_with("--overflow=")) {
+      std::cerr << "Error: Unknown overflow policy.\n";
+      return 1;
+    } else if (arg.starts_with("--recursion-limit=")) {
+      auto value = arg.substr(arg.find('=') + 1);
+      auto [end, error] = std::from_chars(
+          value.data(), value.data() + value.size(), recursionLimit);
+      if (error != std::errc() || end != value.data() + value.size()) {
+        std::cerr << "Error: Invalid recursion limit.\n";
+        return 1;
+      }
+    } else {
+      args.push_back(arg);
+    }
+  }
+  argc = static_cast<int>(args.size());
+  if (!profile.empty() && engine == Engine::VM) {
+    std::cerr << "Error: --profile needs the tree engine.\n";
+    return 1;
+  }
+
   if (argc <= 1) {
     pheonix::repl::repl();
   }
 
-  if (argc == 2 && std::string(argv[1]) == "-h") {
+  if (argc == 2 && args[1] == "-h") {
     help();
     return 0;
   }
 
-  if (argc == 3 && std::string(argv[1]) == "-l") {
-    std::string filename = std::string(argv[2]);
-    std::ifstream input(filename);
+  if (argc == 3 && args[1] == "-l") {
+    std::string filename = args[2];
+    pheonix::lexer::SourceFile input(filename);
     if (!input) {
       std::cerr << "Error: Could not open file.\n";
       return 1; // Exit with error
@@ -52,13 +133,12 @@ int main(int argc, char **argv) {
       std::cout << lexem << std::endl;
     }
     std::cout << std::endl;
-    input.close();
     return 0;
   }
 
-  if (argc == 3 && std::string(argv[1]) == "-p") {
-    std::string filename = std::string(argv[2]);
-    std::ifstream input(filename);
+  if (argc == 3 && args[1] == "-p") {
+    std::string filename = args[2];
+    pheonix::lexer::SourceFile input(filename);
     if (!input) {
       std::cerr << "Error: Could not open file.\n";
       return 1;
@@ -66,28 +146,83 @@ int main(int argc, char **argv) {
     pheonix::parser::Parser p(input);
 
     std::unique_ptr<pheonix::node::Node> output = p.generateParsingTree();
+    if (optimize)
+      pheonix::optimizer::Optimizer().optimize(*output);
     pheonix::ast_view::ASTView visitor;
     output->accept(visitor);
     std::string received = visitor.getResult();
 
     std::cout << received << std::endl;
-    input.close();
     return 0;
   }
 
-  if (argc == 3 && std::string(argv[1]) == "-i") {
-    std::string filename = std::string(argv[2]);
-    std::ifstream input(filename);
+  if (argc == 3 && args[1] == "-i") {
+    std::string filename = args[2];
+    pheonix::lexer::SourceFile input(filename);
     if (!input) {
       std::cerr << "Error: Could not open file.\n";
       return 1;
     }
     pheonix::parser::Parser p(input);
 
-    std::unique_ptr<pheonix::node::Node> output = p.generateParsingTree();
+    std::unique_ptr<pheonix::node::Node> output;
+    try {
+      if (!stream)
+        output = p.generateParsingTree();
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      return 1;
+    }
+    pheonix::profile::Profiler profiler;
+    pheonix::compiler::Compiler compiler;
+    pheonix::vm::VM vm;
+    vm.setRecursionLimit(recursionLimit);
     pheonix::eval::Evaluator evaluator;
-    output->accept(evaluator);
-    input.close();
+    evaluator.setRecursionLimit(recursionLimit);
+    if (!profile.empty()) {
+      evaluator.setProfiler(&profiler);
+      profiler.start();
+    }
+    auto run = [&](pheonix::node::Node &program) {
+      if (optimize)
+        pheonix::optimizer::Optimizer().optimize(program);
+      if (engine == Engine::VM)
+        vm.run(compiler.compile(program));
+      else
+        program.accept(evaluator);
+    };
+    bool failed = false;
+    try {
+      // NOTE: when streaming, the statements before a syntax error are run
+      // and each one is freed once it has run
+      if (stream) {
+        while (auto statement = p.parse())
+          run(**statement);
+      } else {
+        run(*output);
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      failed = true;
+    }
+    // NOTE: a script which fails is profiled up to the error
+    if (!profile.empty()) {
+      profiler.stop();
+      profiler.report(std::cerr);
+      std::ofstream folded(profile);
+      if (!folded) {
+        std::cerr << "Error: Could not write " << profile << ".\n";
+        return 1;
+      }
+      profiler.folded(folded);
+    }
+    if (failed)
+      return 1;
+    if (stats) {
+      const auto &counters = pheonix::eval::cacheStats();
+      std::cerr << "inline caches: " << counters.hits << " hits, "
+                << counters.misses << " misses\n";
+    }
     return 0;
   }
 
@@ -0,0 +1,36 @@
+#include "allocations.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> heapAllocations = 0;
+
+} // namespace
+
+// NOTE: gcc takes free() of memory from the replaced operator new for a
+// mismatch once both are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// counts every heap allocation of the benchmark binary
+void *operator new(size_t size) {
+  heapAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size ? size : 1))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace pheonix::bench {
+
+size_t allocations() {
+  return heapAllocations.load(std::memory_order_relaxed);
+}
+
+} // namespace pheonix::bench
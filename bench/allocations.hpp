@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pheonix::bench {
+
+// heap allocations made by the benchmark binary so far
+size_t allocations();
+
+} // namespace pheonix::bench
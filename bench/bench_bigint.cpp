@@ -0,0 +1,95 @@
+#include "bigint.hpp"
+#include "compiler.hpp"
+#include "evaluator.hpp"
+#include "parser.hpp"
+#include "vm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+// n! and the n-th Fibonacci number, both printed as `<- str` would, 1000!
+// has 2568 digits, the 10000-th Fibonacci number 2090
+std::string factorial(int64_t n) {
+  return "let mut f = 1; let mut i = 1;"
+         "while (i <= " +
+         std::to_string(n) +
+         ") { f = f * i; i = i + 1; }"
+         "f <- str;";
+}
+
+std::string fibonacci(int64_t n) {
+  return "let mut a = 0; let mut b = 1; let mut t = 0; let mut i = 0;"
+         "while (i < " +
+         std::to_string(n) +
+         ") { t = a + b; a = b; b = t; i = i + 1; }"
+         "a <- str;";
+}
+
+void BM_BigIntTree(benchmark::State &state, std::string (*script)(int64_t)) {
+  auto program = parse(script(state.range(0)));
+  for (auto _ : state) {
+    eval::Evaluator evaluator;
+    program->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult().value.asString().data());
+  }
+}
+
+void BM_BigIntVM(benchmark::State &state, std::string (*script)(int64_t)) {
+  compiler::Compiler compiler;
+  auto chunk = compiler.compile(*parse(script(state.range(0))));
+  for (auto _ : state) {
+    vm::VM vm;
+    vm.run(chunk);
+    benchmark::DoNotOptimize(vm.getResult().value.asString().data());
+  }
+}
+
+BENCHMARK_CAPTURE(BM_BigIntTree, factorial, factorial)
+    ->Arg(1000)
+    ->Arg(3000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_BigIntVM, factorial, factorial)
+    ->Arg(1000)
+    ->Arg(3000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_BigIntTree, fibonacci, fibonacci)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_BigIntVM, fibonacci, fibonacci)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->Unit(benchmark::kMillisecond);
+
+// products of operands of as many limbs, split by Karatsuba from
+// BigInt::KARATSUBA limbs on
+void BM_BigIntMultiply(benchmark::State &state) {
+  // 9.63 digits per limb
+  auto digits = static_cast<size_t>(state.range(0)) * 963 / 100;
+  types::BigInt lhs = types::BigInt::parse(std::string(digits, '7'));
+  types::BigInt rhs = types::BigInt::parse(std::string(digits, '3'));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(lhs * rhs);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_BigIntMultiply)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Complexity([](benchmark::IterationCount n) {
+      return std::pow(static_cast<double>(n), std::log2(3.));
+    });
+
+} // namespace
@@ -0,0 +1,258 @@
+#include "allocations.hpp"
+#include "compiler.hpp"
+#include "evaluator.hpp"
+#include "parser.hpp"
+#include "vm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+// `f` returns at once, so only the cost of calling it depends on the body size
+std::string functionWithBody(int statements) {
+  std::string source = "fn f(x) { if (false) {";
+  for (int i = 0; i < statements; ++i)
+    source += " x + " + std::to_string(i) + ";";
+  return source + " } return x; }";
+}
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+void BM_CallTree(benchmark::State &state) {
+  auto declaration = parse(functionWithBody(state.range(0)));
+  auto call = parse("f(1);");
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    call->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_CallTree)->RangeMultiplier(8)->Range(1, 1 << 12)->Complexity();
+
+void BM_CallVM(benchmark::State &state) {
+  auto declaration = parse(functionWithBody(state.range(0)));
+  auto call = parse("f(1);");
+  compiler::Compiler compiler;
+  vm::VM vm;
+  vm.run(compiler.compile(*declaration));
+  auto chunk = compiler.compile(*call);
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    vm.run(chunk);
+    benchmark::DoNotOptimize(vm.getResult());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_CallVM)->RangeMultiplier(8)->Range(1, 1 << 12)->Complexity();
+
+// a small function called in a tight loop, which should not allocate
+const char *const DECLARATIONS = "fn f(x) { let y = x + 1; return y; }"
+                                 "let mut i = 0;";
+const char *const LOOP = "i = 0; while (i < 10000) { i = f(i); }";
+
+void BM_CallLoopTree(benchmark::State &state) {
+  auto declaration = parse(DECLARATIONS);
+  auto loop = parse(LOOP);
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    loop->accept(evaluator);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_CallLoopTree);
+
+void BM_CallLoopVM(benchmark::State &state) {
+  auto declaration = parse(DECLARATIONS);
+  compiler::Compiler compiler;
+  vm::VM vm;
+  vm.run(compiler.compile(*declaration));
+  auto loop = compiler.compile(*parse(LOOP));
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    vm.run(loop);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_CallLoopVM);
+
+// simple statements in a loop, which only pay for running a statement
+const char *const COUNTERS = "let mut i = 0; let mut a = 0;";
+const char *const STATEMENTS =
+    "i = 0; while (i < 10000) { a = i; a = a + 1; a = a * 2; i = i + 1; }";
+
+void BM_StatementsTree(benchmark::State &state) {
+  auto declaration = parse(COUNTERS);
+  auto loop = parse(STATEMENTS);
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  for (auto _ : state) {
+    loop->accept(evaluator);
+  }
+  state.SetItemsProcessed(state.iterations() * 40000);
+}
+BENCHMARK(BM_StatementsTree);
+
+// recursion `depth` calls deep, which is not and which is a tail call
+const char *const RECURSIVE =
+    "fn sum(n) { if (n == 0) { return 0; } return 1 + sum(n - 1); }"
+    "fn loop(n, acc) { if (n == 0) { return acc; } return loop(n - 1, acc + "
+    "1); }";
+
+std::string recursiveCall(const char *function, int64_t depth) {
+  return std::string(function) + "(" + std::to_string(depth) +
+         (std::string(function) == "loop" ? ", 0);" : ");");
+}
+
+template <bool Tail> void BM_RecursionTree(benchmark::State &state) {
+  auto declaration = parse(RECURSIVE);
+  auto call = parse(recursiveCall(Tail ? "loop" : "sum", state.range(0)));
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  for (auto _ : state) {
+    call->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RecursionTree<false>)->Arg(1000)->Arg(50000);
+BENCHMARK(BM_RecursionTree<true>)->Arg(1000)->Arg(50000);
+
+template <bool Tail> void BM_RecursionVM(benchmark::State &state) {
+  auto declaration = parse(RECURSIVE);
+  compiler::Compiler compiler;
+  vm::VM vm;
+  vm.run(compiler.compile(*declaration));
+  auto chunk = compiler.compile(
+      *parse(recursiveCall(Tail ? "loop" : "sum", state.range(0))));
+  for (auto _ : state) {
+    vm.run(chunk);
+    benchmark::DoNotOptimize(vm.getResult());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RecursionVM<false>)->Arg(1000)->Arg(50000);
+BENCHMARK(BM_RecursionVM<true>)->Arg(1000)->Arg(50000);
+
+// guards decided by their cheap left side, the call is never needed
+const char *const GUARDED =
+    "fn expensive(x) { let mut j = 0; while (j < 20) { j = j + 1; } "
+    "return x > 0; }"
+    "let mut i = 0; let mut hits = 0;";
+const char *const GUARDS =
+    "i = 0; while (i < 1000) {"
+    "  if (i < 0 && expensive(i)) { hits = hits + 1; }"
+    "  if (i >= 0 || expensive(i)) { hits = hits + 1; }"
+    "  i = i + 1; }";
+
+void BM_GuardTree(benchmark::State &state) {
+  auto declaration = parse(GUARDED);
+  auto guards = parse(GUARDS);
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  for (auto _ : state) {
+    guards->accept(evaluator);
+  }
+  state.SetItemsProcessed(state.iterations() * 2000);
+}
+BENCHMARK(BM_GuardTree);
+
+void BM_GuardVM(benchmark::State &state) {
+  auto declaration = parse(GUARDED);
+  compiler::Compiler compiler;
+  vm::VM vm;
+  vm.run(compiler.compile(*declaration));
+  auto guards = compiler.compile(*parse(GUARDS));
+  for (auto _ : state) {
+    vm.run(guards);
+  }
+  state.SetItemsProcessed(state.iterations() * 2000);
+}
+BENCHMARK(BM_GuardVM);
+
+// `stages` functions composed with `|`, the pipeline adds `stages` to x
+std::string pipeline(int64_t stages) {
+  std::string source = "inc";
+  for (int64_t i = 1; i < stages; ++i)
+    source += " | inc";
+  return source;
+}
+
+const char *const STAGE = "fn inc(x) { return x + 1; }";
+
+void BM_ComposeTree(benchmark::State &state) {
+  auto declaration = parse(STAGE);
+  auto composition = parse(pipeline(state.range(0)) + ";");
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  for (auto _ : state) {
+    composition->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComposeTree)->RangeMultiplier(4)->Range(4, 256);
+
+void BM_PipelineTree(benchmark::State &state) {
+  auto declaration = parse(std::string(STAGE) + "let p = " +
+                           pipeline(state.range(0)) + ";");
+  auto call = parse("p(0);");
+  eval::Evaluator evaluator;
+  declaration->accept(evaluator);
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    call->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PipelineTree)->RangeMultiplier(4)->Range(4, 256);
+
+void BM_PipelineVM(benchmark::State &state) {
+  auto declaration = parse(std::string(STAGE) + "let p = " +
+                           pipeline(state.range(0)) + ";");
+  compiler::Compiler compiler;
+  vm::VM vm;
+  vm.run(compiler.compile(*declaration));
+  auto call = compiler.compile(*parse("p(0);"));
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    vm.run(call);
+    benchmark::DoNotOptimize(vm.getResult());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PipelineVM)->RangeMultiplier(4)->Range(4, 256);
+
+} // namespace
@@ -0,0 +1,130 @@
+#include "compiler.hpp"
+#include "evaluator.hpp"
+#include "parser.hpp"
+#include "vm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace pheonix;
+
+namespace {
+
+// scripts of bench/corpus, each run from scratch in every iteration
+std::string load(const std::string &name) {
+  std::ifstream in(std::string(PHEONIX_BENCH_CORPUS) + "/" + name);
+  if (!in)
+    throw std::runtime_error("Could not open corpus script " + name);
+  std::stringstream source;
+  source << in.rdbuf();
+  return source.str();
+}
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+// NOTE: the scripts print their result, which is dropped while they run
+class Silence {
+public:
+  Silence() : saved(std::cout.rdbuf(&sink)) {}
+  ~Silence() { std::cout.rdbuf(saved); }
+
+private:
+  struct Sink : std::streambuf {
+    int overflow(int c) override { return c; }
+  } sink;
+  std::streambuf *saved;
+};
+
+// the lines of the script grouped into inputs the REPL would run at once,
+// a statement may span several lines until its brackets are closed
+std::vector<std::string> replInputs(const std::string &source) {
+  std::vector<std::string> inputs;
+  std::istringstream in(source);
+  std::string line;
+  std::string input;
+  int depth = 0;
+  while (std::getline(in, line)) {
+    input += line + "\n";
+    for (char c : line) {
+      if (c == '(' || c == '[' || c == '{')
+        ++depth;
+      else if (c == ')' || c == ']' || c == '}')
+        --depth;
+    }
+    if (depth == 0) {
+      inputs.push_back(input);
+      input.clear();
+    }
+  }
+  return inputs;
+}
+
+void BM_CorpusParse(benchmark::State &state, const char *name) {
+  std::string source = load(name);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parse(source));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(source.size()));
+}
+
+void BM_CorpusTree(benchmark::State &state, const char *name) {
+  auto program = parse(load(name));
+  Silence silence;
+  for (auto _ : state) {
+    eval::Evaluator evaluator;
+    program->accept(evaluator);
+  }
+}
+
+void BM_CorpusVM(benchmark::State &state, const char *name) {
+  compiler::Compiler compiler;
+  auto chunk = compiler.compile(*parse(load(name)));
+  Silence silence;
+  for (auto _ : state) {
+    vm::VM vm;
+    vm.run(chunk);
+  }
+}
+
+// the script typed into the REPL: every input is parsed and run on its own,
+// behind a checkpoint
+void BM_CorpusRepl(benchmark::State &state, const char *name) {
+  std::vector<std::string> inputs = replInputs(load(name));
+  Silence silence;
+  for (auto _ : state) {
+    eval::Evaluator evaluator;
+    for (const std::string &input : inputs) {
+      evaluator.checkpoint();
+      parse(input)->accept(evaluator);
+    }
+  }
+}
+
+#define CORPUS(script)                                                         \
+  BENCHMARK_CAPTURE(BM_CorpusParse, script, #script ".phx");                   \
+  BENCHMARK_CAPTURE(BM_CorpusTree, script, #script ".phx")                     \
+      ->Unit(benchmark::kMillisecond);                                         \
+  BENCHMARK_CAPTURE(BM_CorpusVM, script, #script ".phx")                       \
+      ->Unit(benchmark::kMillisecond);                                         \
+  BENCHMARK_CAPTURE(BM_CorpusRepl, script, #script ".phx")                     \
+      ->Unit(benchmark::kMillisecond)
+
+CORPUS(arithmetic);
+CORPUS(fib);
+CORPUS(pipeline);
+CORPUS(strings);
+CORPUS(closures);
+
+} // namespace
@@ -0,0 +1,95 @@
+#include "compiler.hpp"
+#include "evaluator.hpp"
+#include "operator_visitor.hpp"
+#include "parser.hpp"
+#include "vm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+using types::OperatorType;
+using types::OverflowPolicy;
+
+namespace {
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+// a loop of checked additions, multiplications and divisions, the sum grows
+// past 32 bits
+std::string loop(int64_t count) {
+  return "let mut i = 0; let mut sum = 0;"
+         "while (i < " +
+         std::to_string(count) +
+         ") { sum = sum + i * 4099 - i / 3; i = i + 1; }"
+         "sum;";
+}
+
+void BM_IntegerLoopTree(benchmark::State &state) {
+  auto program = parse(loop(state.range(0)));
+  for (auto _ : state) {
+    eval::Evaluator evaluator;
+    program->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult().value.asInteger());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntegerLoopTree)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_IntegerLoopVM(benchmark::State &state) {
+  compiler::Compiler compiler;
+  auto chunk = compiler.compile(*parse(loop(state.range(0))));
+  for (auto _ : state) {
+    vm::VM vm;
+    vm.run(chunk);
+    benchmark::DoNotOptimize(vm.getResult().value.asInteger());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntegerLoopVM)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+
+// the checked kernels alone, on operands which do not overflow
+void BM_IntegerChecked(benchmark::State &state, OperatorType op) {
+  eval::ObjectValue lhs = types::Integer(3037000499);
+  eval::ObjectValue rhs = types::Integer(3037000499);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs);
+    benchmark::DoNotOptimize(eval::binaryOperator(lhs, rhs, op));
+  }
+}
+BENCHMARK_CAPTURE(BM_IntegerChecked, add, OperatorType::PLUS);
+BENCHMARK_CAPTURE(BM_IntegerChecked, mul, OperatorType::STAR);
+BENCHMARK_CAPTURE(BM_IntegerChecked, div, OperatorType::SLASH);
+
+// an addition which overflows every time, under the policies which do not
+// throw
+void BM_IntegerOverflow(benchmark::State &state, OverflowPolicy policy) {
+  eval::ObjectValue lhs = types::Integer(std::numeric_limits<int64_t>::max());
+  eval::ObjectValue rhs = types::Integer(1);
+  OverflowPolicy previous = types::overflowPolicy();
+  types::setOverflowPolicy(policy);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs);
+    benchmark::DoNotOptimize(
+        eval::binaryOperator(lhs, rhs, OperatorType::PLUS));
+  }
+  types::setOverflowPolicy(previous);
+}
+BENCHMARK_CAPTURE(BM_IntegerOverflow, wrap, OverflowPolicy::WRAP);
+BENCHMARK_CAPTURE(BM_IntegerOverflow, promote, OverflowPolicy::PROMOTE);
+
+} // namespace
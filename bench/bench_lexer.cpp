@@ -0,0 +1,94 @@
+#include "lexer.hpp"
+#include "scan.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+// about `megabytes` of code with identifiers, numbers, strings and comments
+std::string generatedSource(size_t megabytes) {
+  std::string source;
+  for (size_t i = 0; source.size() < megabytes << 20; ++i) {
+    auto n = std::to_string(i);
+    source += "// function number " + n + "\n"
+              "fn function_" + n + "(argument, mut counter) {\n"
+              "  let text = \"some string literal " + n + "\";\n"
+              "  counter = counter + argument * " + n + " - 3.25;\n"
+              "  return text <- str;\n}\n";
+  }
+  return source;
+}
+
+size_t lexemsIn(lexer::Lexer &lexer) {
+  size_t count = 0;
+  while (lexer.nextLexem() != token::TokenType::END_OF_FILE)
+    ++count;
+  return count;
+}
+
+void BM_LexStream(benchmark::State &state) {
+  const auto source = generatedSource(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::istringstream in(source);
+    lexer::Lexer lexer(in);
+    benchmark::DoNotOptimize(lexemsIn(lexer));
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_LexStream)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+void BM_LexView(benchmark::State &state) {
+  const auto source = generatedSource(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    lexer::Lexer lexer{std::string_view(source)};
+    benchmark::DoNotOptimize(lexemsIn(lexer));
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_LexView)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+// generated code, mostly long comments and identifiers
+std::string commentedSource(size_t megabytes) {
+  std::string source;
+  for (size_t i = 0; source.size() < megabytes << 20; ++i) {
+    auto n = std::to_string(i);
+    source += "// generated from the description of record number " + n +
+              ", do not edit by hand\n"
+              "/* the record keeps its own counters and the name of the\n"
+              "   table it was read from, see the generator for details */\n"
+              "let generated_record_identifier_" + n +
+              "        =  generated_table_lookup_function_name(" + n +
+              ");\n";
+  }
+  return source;
+}
+
+void BM_LexScan(benchmark::State &state) {
+  auto isa = static_cast<lexer::scan::Isa>(state.range(0));
+  if (!lexer::scan::supported(isa)) {
+    state.SkipWithError("instruction set not supported");
+    return;
+  }
+  const auto source = commentedSource(16);
+  auto previous = lexer::scan::current();
+  lexer::scan::use(isa);
+  for (auto _ : state) {
+    lexer::Lexer lexer{std::string_view(source)};
+    benchmark::DoNotOptimize(lexemsIn(lexer));
+  }
+  lexer::scan::use(previous);
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_LexScan)
+    ->ArgName("isa")
+    ->Arg(static_cast<int>(lexer::scan::Isa::SCALAR))
+    ->Arg(static_cast<int>(lexer::scan::Isa::SSE2))
+    ->Arg(static_cast<int>(lexer::scan::Isa::AVX2))
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,66 @@
+#include "operator_visitor.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace pheonix;
+using types::OperatorType;
+
+namespace {
+
+void BM_Binary(benchmark::State &state, OperatorType op, eval::ObjectValue lhs,
+               eval::ObjectValue rhs) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs);
+    benchmark::DoNotOptimize(eval::binaryOperator(lhs, rhs, op));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Binary, int_add, OperatorType::PLUS, types::Integer(3),
+                  types::Integer(4));
+BENCHMARK_CAPTURE(BM_Binary, int_less, OperatorType::LESS, types::Integer(3),
+                  types::Integer(4));
+BENCHMARK_CAPTURE(BM_Binary, flt_mul, OperatorType::STAR, types::Float(1.5),
+                  types::Float(2.5));
+BENCHMARK_CAPTURE(BM_Binary, bol_and, OperatorType::AND, true, false);
+BENCHMARK_CAPTURE(BM_Binary, str_concat, OperatorType::PLUS,
+                  std::string("Kaczka"), std::string("Duck"));
+
+// the same operators through the inline cache of a single site
+void BM_BinaryCached(benchmark::State &state, OperatorType op,
+                     eval::ObjectValue lhs, eval::ObjectValue rhs) {
+  eval::InlineCache cache;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs);
+    benchmark::DoNotOptimize(eval::binaryOperator(lhs, rhs, op, cache));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_BinaryCached, int_add, OperatorType::PLUS,
+                  types::Integer(3), types::Integer(4));
+BENCHMARK_CAPTURE(BM_BinaryCached, int_less, OperatorType::LESS,
+                  types::Integer(3), types::Integer(4));
+BENCHMARK_CAPTURE(BM_BinaryCached, flt_mul, OperatorType::STAR,
+                  types::Float(1.5), types::Float(2.5));
+BENCHMARK_CAPTURE(BM_BinaryCached, str_concat, OperatorType::PLUS,
+                  std::string("Kaczka"), std::string("Duck"));
+
+void BM_Prefix(benchmark::State &state) {
+  eval::ObjectValue value = types::Integer(3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(
+        eval::prefixOperator(value, OperatorType::MINUS));
+  }
+}
+BENCHMARK(BM_Prefix);
+
+void BM_Cast(benchmark::State &state) {
+  eval::ObjectValue value = types::Integer(3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(eval::castOperator(value, types::CastType::FLT));
+  }
+}
+BENCHMARK(BM_Cast);
+
+} // namespace
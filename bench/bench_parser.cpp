@@ -0,0 +1,49 @@
+#include "allocations.hpp"
+#include "parser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+// a script in the style of a generated one, every function is different
+std::string generatedScript(int functions) {
+  std::string source;
+  for (int i = 0; i < functions; ++i) {
+    auto n = std::to_string(i);
+    source += "fn f" + n + "(a, mut b) {\n"
+              "  let mut x = a * " + n + " + (b - 1) / 2;\n"
+              "  while (x < 100 && x != 7) { x = x + 1; }\n"
+              "  if (x >= 10) { return x <- flt; } else { return \"s" +
+              n + "\"; }\n}\n"
+              "let v" + n + " = f" + n + "(" + n + ", 2) + 3.5;\n";
+  }
+  return source;
+}
+
+void BM_Parse(benchmark::State &state) {
+  const auto source = generatedScript(static_cast<int>(state.range(0)));
+  size_t allocations = 0;
+  size_t blocks = 0;
+  for (auto _ : state) {
+    std::istringstream in(source);
+    size_t before = bench::allocations();
+    {
+      parser::Parser p(in);
+      auto program = p.generateParsingTree();
+      blocks = static_cast<node::Program &>(*program).arena->blocks();
+      benchmark::DoNotOptimize(program);
+    }
+    allocations = bench::allocations() - before;
+  }
+  state.counters["allocations"] = static_cast<double>(allocations);
+  state.counters["arena_blocks"] = static_cast<double>(blocks);
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_Parse)->RangeMultiplier(10)->Range(10, 10000);
+
+} // namespace
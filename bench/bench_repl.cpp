@@ -0,0 +1,64 @@
+#include "evaluator.hpp"
+#include "parser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+// a session which has declared `globals` variables and functions so far
+std::string session(int globals) {
+  std::string source = "let mut x = 0;";
+  for (int i = 0; i < globals; ++i) {
+    auto n = std::to_string(i);
+    source += "let v" + n + " = " + n + "; fn f" + n + "(a) { return a; }";
+  }
+  return source;
+}
+
+// one line of the session, as the REPL used to run it: a copy of the whole
+// context is kept for the case the line fails
+void BM_ReplLineCopy(benchmark::State &state) {
+  auto declarations = parse(session(state.range(0)));
+  auto line = parse("x = x + 1;");
+  eval::Evaluator evaluator;
+  eval::Evaluator previous;
+  declarations->accept(evaluator);
+  for (auto _ : state) {
+    previous.setContext(evaluator.getContext());
+    line->accept(evaluator);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ReplLineCopy)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Complexity();
+
+void BM_ReplLineCheckpoint(benchmark::State &state) {
+  auto declarations = parse(session(state.range(0)));
+  auto line = parse("x = x + 1;");
+  eval::Evaluator evaluator;
+  declarations->accept(evaluator);
+  for (auto _ : state) {
+    evaluator.checkpoint();
+    line->accept(evaluator);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ReplLineCheckpoint)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Complexity();
+
+} // namespace
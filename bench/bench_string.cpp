@@ -0,0 +1,71 @@
+#include "allocations.hpp"
+#include "compiler.hpp"
+#include "evaluator.hpp"
+#include "parser.hpp"
+#include "vm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+using namespace pheonix;
+
+namespace {
+
+std::unique_ptr<node::Node> parse(const std::string &source) {
+  std::istringstream in(source);
+  parser::Parser p(in);
+  return p.generateParsingTree();
+}
+
+// `s = s + x` repeated, then the characters of `s` are read once, as print
+// would read them
+std::string appends(int64_t count) {
+  return "let mut s = \"\"; let mut i = 0;"
+         "while (i < " +
+         std::to_string(count) +
+         ") { s = s + \"x\"; i = i + 1; }"
+         "s;";
+}
+
+void BM_AppendTree(benchmark::State &state) {
+  auto program = parse(appends(state.range(0)));
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    eval::Evaluator evaluator;
+    program->accept(evaluator);
+    benchmark::DoNotOptimize(evaluator.getResult().value.asString().data());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AppendTree)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oN);
+
+void BM_AppendVM(benchmark::State &state) {
+  compiler::Compiler compiler;
+  auto chunk = compiler.compile(*parse(appends(state.range(0))));
+  size_t before = bench::allocations();
+  for (auto _ : state) {
+    vm::VM vm;
+    vm.run(chunk);
+    benchmark::DoNotOptimize(vm.getResult().value.asString().data());
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(bench::allocations() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_AppendVM)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oN);
+
+} // namespace
@@ -0,0 +1,71 @@
+#include "object.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <variant>
+#include <vector>
+
+using namespace pheonix;
+
+namespace {
+
+// ObjectValue before it was made compact, kept for comparison
+using LegacyValue = std::variant<std::monostate, types::Integer, types::Float,
+                                 std::string, bool, eval::Function, void *>;
+
+template <typename T> std::vector<T> values(size_t n) {
+  std::vector<T> result;
+  result.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 4 == 3)
+      result.emplace_back(std::string("Kaczka"));
+    else
+      result.emplace_back(types::Integer(static_cast<int>(i)));
+  }
+  return result;
+}
+
+template <typename T> void counters(benchmark::State &state) {
+  state.counters["value_bytes"] = sizeof(T);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T> void BM_Copy(benchmark::State &state) {
+  auto source = values<T>(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto copy = source;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  counters<T>(state);
+}
+
+int integer(const eval::ObjectValue &value) {
+  if (value.type() == eval::ObjectValue::Type::INT)
+    return value.asInteger().getValue();
+  return 0;
+}
+
+int integer(const LegacyValue &value) {
+  if (auto *result = std::get_if<types::Integer>(&value))
+    return result->getValue();
+  return 0;
+}
+
+template <typename T> void BM_Sum(benchmark::State &state) {
+  auto source = values<T>(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &value : source)
+      sum += integer(value);
+    benchmark::DoNotOptimize(sum);
+  }
+  counters<T>(state);
+}
+
+BENCHMARK_TEMPLATE(BM_Copy, eval::ObjectValue)->Range(64, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Copy, LegacyValue)->Range(64, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Sum, eval::ObjectValue)->Range(64, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Sum, LegacyValue)->Range(64, 1 << 16);
+
+} // namespace
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace pheonix::arena {
+
+// Monotonic bump allocator. Memory is never reused, it is returned all at
+// once when the arena is destroyed.
+class Arena {
+public:
+  Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *allocate(size_t size, size_t alignment);
+  // number of blocks requested from the heap
+  size_t blocks() const { return chunks.size(); }
+  size_t bytes() const { return used; }
+
+  // Arena used by allocations of the current thread, nullptr if none.
+  static Arena *current();
+
+  // Makes the arena current until the end of the scope.
+  class Scope {
+  public:
+    explicit Scope(Arena &arena);
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+    ~Scope();
+
+  private:
+    Arena *previous;
+  };
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> chunks;
+  std::byte *position;
+  size_t left;
+  size_t nextSize;
+  size_t used;
+};
+
+} // namespace pheonix::arena
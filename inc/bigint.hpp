@@ -0,0 +1,65 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pheonix::types {
+
+// Value of an `int` out of 64 bits, Integer arithmetic is promoted to it when
+// it overflows. Like String it is immutable, copies share the limbs.
+//
+// The magnitude is kept in 32 bit limbs, least significant first, next to
+// the sign. Operands of at least KARATSUBA limbs are multiplied by splitting
+// them in halves, division is Knuth's algorithm D. Division truncates, as
+// that of Integer does.
+class BigInt {
+public:
+  static constexpr size_t KARATSUBA = 32;
+
+  BigInt(int64_t value = 0);
+  // NOTE: `value` is truncated, it has to be finite
+  static BigInt fromDouble(double value);
+  // decimal digits with an optional leading minus
+  static BigInt parse(std::string_view digits);
+  BigInt(const BigInt &other);
+  BigInt(BigInt &&other) noexcept;
+  BigInt &operator=(const BigInt &other);
+  BigInt &operator=(BigInt &&other) noexcept;
+  ~BigInt();
+
+  friend BigInt operator+(const BigInt &lhs, const BigInt &rhs);
+  friend BigInt operator-(const BigInt &lhs, const BigInt &rhs);
+  friend BigInt operator*(const BigInt &lhs, const BigInt &rhs);
+  // NOTE: both throw on division by zero
+  friend BigInt operator/(const BigInt &lhs, const BigInt &rhs);
+  friend BigInt operator%(const BigInt &lhs, const BigInt &rhs);
+  BigInt operator-() const;
+
+  bool operator==(const BigInt &other) const;
+  std::strong_ordering operator<=>(const BigInt &other) const;
+
+  // count of limbs of the magnitude, 0 for zero
+  size_t limbs() const;
+  bool negative() const;
+  // the value if it fits in 64 bits
+  std::optional<int64_t> toInteger() const;
+  double toDouble() const;
+  std::string str() const;
+
+private:
+  struct Rep;
+
+  explicit BigInt(Rep *rep) : rep(rep) {}
+  void release();
+
+  Rep *rep;
+};
+
+std::ostream &operator<<(std::ostream &os, const BigInt &value);
+
+} // namespace pheonix::types
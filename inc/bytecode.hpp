@@ -0,0 +1,71 @@
+#pragma once
+
+#include "inline_cache.hpp"
+#include "object.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pheonix::bytecode {
+
+enum class OpCode : uint8_t {
+  CONSTANT,        // push constants[a]
+  LOAD,            // push variable (a - slot, b - symbol, c - is dynamic)
+  REFERENCE,       // push reference to variable (as in LOAD)
+  DECLARE,         // pop value, declare slot a, b - is mutable
+  CHECK_ASSIGN,    // check that variable (as in LOAD) is declared and mutable
+  ASSIGN,          // store top of the stack into variable (as in LOAD)
+  BINARY,          // pop rhs, pop lhs, push lhs a rhs, a - OperatorType,
+                   // b - index of its inline cache
+  UNARY,           // pop value, push a value, a - OperatorType
+  CAST,            // pop value, push value <- a, a - CastType
+  MAKE_FUNCTION,   // push functions[a]
+  DEFINE_FUNCTION, // declare slot a as functions[b]
+  CALL,            // call with callSites[a], b - is tail call, which
+                   // replaces the frame when nothing can tell
+  DEBUG_CALL,      // call as CALL printing its arguments, b - its node, to
+                   // print its span
+  POP_RESULT,      // pop value into the result register
+  CLEAR_RESULT,    // reset the result register
+  JUMP,            // jump to a
+  BRANCH,          // pop bool, on false jump to a, on non bool jump to b
+  SHORT_CIRCUIT,   // if top of the stack is bool b, keep it and jump to a
+  RETURN,          // pop value into the result register and leave frame
+  PRINT,           // print embedded function argument, a - its symbol
+  END,             // end of chunk
+};
+
+struct Instruction {
+  OpCode op;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+};
+
+struct Chunk {
+  std::vector<Instruction> code;
+  std::vector<eval::Object> constants;
+  std::vector<eval::Function> functions;
+  // NOTE: which arguments are passed by reference
+  std::vector<std::vector<bool>> callSites;
+  // NOTE: filled while the chunk runs, by BINARY instructions
+  mutable std::vector<eval::InlineCache> caches;
+  // statement each instruction was compiled from, its span is in `spans`
+  std::vector<uint32_t> nodes;
+  std::shared_ptr<const node::Spans> spans;
+  // statement of the instructions emitted next
+  uint32_t statement = node::Spans::NONE;
+
+  size_t emit(OpCode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0);
+  uint32_t addConstant(const eval::Object &constant);
+  // nullptr if it is not known
+  const node::Span *span(const Instruction *instruction) const;
+};
+
+std::string opCodeToString(OpCode op);
+std::ostream &operator<<(std::ostream &os, const Chunk &chunk);
+
+} // namespace pheonix::bytecode
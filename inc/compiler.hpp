@@ -0,0 +1,79 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "node.hpp"
+#include "object.hpp"
+#include "visitor.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pheonix::compiler {
+
+// Lowers the AST into a bytecode::Chunk executed by vm::VM.
+class Compiler : public visitor::Visitor {
+public:
+  // `spans` are those of the compiled code, when it is not a program
+  explicit Compiler(std::shared_ptr<const node::Spans> spans = nullptr);
+  std::shared_ptr<const bytecode::Chunk> compile(node::Node &root);
+
+  void visit(node::Program &p) override;
+  void visit(node::Parameter &p) override;
+  void visit(node::DeclarationArguments &p) override;
+  void visit(node::Block &p) override;
+  void visit(node::FunctionDeclaration &fd) override;
+  void visit(node::VariableDeclaration &vd) override;
+  void visit(node::WhileLoopStatement &wls) override;
+  void visit(node::IfStatement &wls) override;
+  void visit(node::ReturnStatement &rs) override;
+  void visit(node::ExpressionStatement &es) override;
+  void visit(node::NullStatement &ns) override;
+  void visit(node::AssignementExpression &ae) override;
+  void visit(node::OrExpression &oe) override;
+  void visit(node::AndExpression &ae) override;
+  void visit(node::ComparisonExpression &ce) override;
+  void visit(node::RelationalExpression &re) override;
+  void visit(node::MultiplicativeExpression &me) override;
+  void visit(node::CompositiveExpression &me) override;
+  void visit(node::AdditiveExpression &ae) override;
+  void visit(node::CastExpression &ce) override;
+  void visit(node::PrefixExpression &pe) override;
+  void visit(node::CallExpression &ce) override;
+  void visit(node::DebugExpression &de) override;
+  void visit(node::CallArguments &ca) override;
+  void visit(node::LambdaExpression &le) override;
+  void visit(node::Identifier &i) override;
+  void visit(node::ParentExpression &pe) override;
+  void visit(node::Literal &il) override;
+  void visit(node::TypeSpecifier &ts) override;
+  void visit(node::PrintFunction &ts) override;
+
+private:
+  void binary(node::Node &left, node::Node &right, types::OperatorType op);
+  // `||` when `decisive` is true, `&&` otherwise
+  void logical(node::Node &left, node::Node &right, types::OperatorType op,
+               bool decisive);
+  void operation(types::OperatorType op);
+  // `op` is CALL or DEBUG_CALL, `b` its operand
+  void call(node::Node &function, node::Node &arguments, bytecode::OpCode op,
+            uint32_t b);
+  void variable(bytecode::OpCode op, size_t depth, size_t slot,
+                symbol::Symbol symbol);
+  eval::Function function(node::Node &arguments,
+                          const std::shared_ptr<node::Node> &statements,
+                          std::shared_ptr<const symbol::Layout> layout);
+  uint32_t here() const;
+  void patch(size_t instruction, uint32_t a);
+  void patch(size_t instruction, uint32_t a, uint32_t b);
+
+  std::shared_ptr<bytecode::Chunk> chunk;
+  std::vector<eval::Param> params;
+  std::shared_ptr<const node::Spans> spans;
+};
+
+// compiles every stage of the function that has no code yet, the code is
+// shared with the functions composed from it
+void ensureCompiled(const eval::Function &function);
+
+} // namespace pheonix::compiler
@@ -2,34 +2,125 @@
 
 #include "node.hpp"
 #include "object.hpp"
+#include "symbol.hpp"
 
 #include <cassert>
+#include <deque>
 #include <functional>
-#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace pheonix::context {
 
-using ContextIterator = std::map<std::string, eval::Object>::iterator;
+// frames which may be pushed on top of the global one
+constexpr size_t DEFAULT_RECURSION_LIMIT = 100000;
 
+// Variables live in flat frames addressed by the slots given by
+// resolver::Resolver. Scoping is dynamic, so the most recent binding of every
+// symbol is additionally kept in a table indexed by symbol (shallow binding),
+// which makes lookups of names from outer frames O(1) as well.
 struct Context {
 public:
-  Context() : context() { push_scope(); }
-  void pop_scope();
-  void push_scope();
-  ContextIterator end();
-  ContextIterator find(const std::string &ident);
-  ContextIterator find_in_current_scope(const std::string &ident);
-  void insert(const std::string &ident, const eval::Object &value);
+  Context();
+  // NOTE: throws once `recursionLimit` frames are pushed
+  void push_frame(const symbol::Layout &layout);
+  void pop_frame();
+  // count of frames, the global one included
+  size_t depth() const;
+  // NOTE: pops the frames pushed on top of the first `depth` ones, such as
+  // those of the calls a runtime error left
+  void unwind(size_t depth);
+  // NOTE: the frame of the next stage of a pipeline, which takes the place
+  // of the current one and keeps its slots if it fits in them
+  void replace_frame(const symbol::Layout &layout);
+
+  bool contains(size_t depth, size_t slot, symbol::Symbol symbol) const;
+  bool contains_in_current_frame(size_t slot) const;
+  eval::Object &at(size_t depth, size_t slot, symbol::Symbol symbol);
+  eval::Object &at_ref(size_t depth, size_t slot, symbol::Symbol symbol);
+  eval::Object &local(size_t slot, symbol::Symbol symbol);
+  eval::Object &dynamic(symbol::Symbol symbol);
+  void insert(size_t slot, const eval::Object &value);
+  void insert(size_t slot, eval::Object &&value);
+  void insertRef(size_t slot, eval::Object &referenced, bool mut = false);
+  void assign(size_t depth, size_t slot, symbol::Symbol symbol,
+              const eval::ObjectValue &value);
+
+  // NOTE: a tail call may replace the current frame when nothing can tell:
+  // every name bound in it is a parameter, bound again on entry, of the
+  // called function, whose frame has `layout`
+  bool replaceableBy(const symbol::Layout &layout, size_t parameters) const;
+  bool inCurrentFrame(const eval::Object &object) const;
+  void setRecursionLimit(size_t limit);
+
+  // NOTE: name based access to the global frame, e.g. for embedded functions
   eval::Object &at(const std::string &ident);
-  eval::Object &at_ref(const std::string &ident);
-  void insertRef(const std::string &ident, const std::string &referenced,
-                 bool mut = false);
+  void insert(const std::string &ident, const eval::Object &value);
+
+  Context(const Context &other);
+  Context &operator=(const Context &other);
   Context clone() const;
 
+  // NOTE: from a checkpoint on, the first change of every global slot is
+  // recorded, so rolling back costs as much as was changed, not the whole
+  // state; taken between statements, e.g. by the REPL before every line
+  void checkpoint();
+  void rollback();
+
 private:
-  std::vector<std::map<std::string, eval::Object>> context;
+  // NOTE: standard layout with the object first, see slotOf
+  struct Slot {
+    eval::Object object;
+    symbol::Symbol symbol;
+    bool bound;
+    // changed since the last checkpoint
+    bool recorded;
+  };
+  struct Frame {
+    // nullptr for the global frame, whose slots are in `globals`
+    Slot *base;
+    size_t size;
+    // position in `shadowed` when the frame was pushed
+    size_t mark;
+    // top of the frame stack before the frame was pushed
+    size_t block;
+    size_t used;
+  };
+  struct Block {
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity;
+    size_t used;
+  };
+
+  Frame &pushFrame(size_t size);
+  Slot &slotIn(const Frame &frame, size_t slot);
+  Slot &slotAt(size_t slot);
+  const Slot *findSlot(size_t slot) const;
+  void bind(Slot &slot);
+  void rebind();
+  void record(Slot &slot);
+  static Slot &slotOf(eval::Object &object);
+
+  // NOTE: deque keeps references to slots valid while the global frame grows
+  std::deque<Slot> globals;
+  // NOTE: call frames are contiguous runs of slots taken from blocks, which
+  // are kept when frames are popped, so calls do not allocate once the
+  // blocks are there; a frame which does not fit goes to the next block
+  std::vector<Block> blocks;
+  size_t block;
+  std::vector<Frame> frames;
+  std::vector<eval::Object *> bindings;
+  std::vector<std::pair<symbol::Symbol, eval::Object *>> shadowed;
+  // global slots as they were at the last checkpoint
+  struct Change {
+    size_t slot;
+    eval::Object object;
+    bool bound;
+  };
+  std::vector<Change> changes;
+  bool recording;
+  size_t recursionLimit;
 };
 
 } // namespace pheonix::context
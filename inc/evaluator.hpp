@@ -4,6 +4,7 @@
 #include "node.hpp"
 #include "object.hpp"
 #include "operator_visitor.hpp"
+#include "profile.hpp"
 #include "types.hpp"
 #include "visitor.hpp"
 
@@ -15,8 +16,6 @@
 
 namespace pheonix::eval {
 
-bool operator==(const ObjectValue &lhs, const ObjectValue &rhs);
-
 class Evaluator : public visitor::Visitor {
 public:
   Evaluator();
@@ -25,6 +24,12 @@ public:
   std::vector<Object> getResultVec();
   context::Context getContext();
   void setContext(const context::Context &con);
+  void setRecursionLimit(size_t limit);
+  // records calls and statements run while set, nullptr stops it
+  void setProfiler(profile::Profiler *profiler);
+  // undoes the statements run since the checkpoint, e.g. after an error
+  void checkpoint();
+  void rollback();
 
   void visit(node::Program &p) override;
   void visit(node::Parameter &p) override;
@@ -58,15 +63,40 @@ public:
   void visit(node::PrintFunction &ts) override;
 
 public:
-  std::string lastName;
-  std::vector<std::string> lastNames;
+  // objects referenced by the last identifier and by call arguments,
+  // nullptr for values
+  Object *lastReference;
+  std::vector<Object *> lastReferences;
 
 private:
+  // runs the statements of a body, which stops at its return, or of the
+  // program, giving their errors their position
+  void statements(const std::vector<std::unique_ptr<node::Node>> &statements,
+                  bool body);
+  // line the node starts at, 0 if unknown
+  size_t line(const node::Node &node) const;
+  void call(ObjectValue called, size_t base);
+  void enter(const Function &function, size_t base);
+  void nextStage(const Stage &stage);
+  bool tailCall(const ObjectValue &called, size_t base);
+
   bool isReturning;
   bool isDebugging;
+  // the running body is the last stage of a call, its return may be a tail
+  // call, which the running call then continues with
+  bool inTailPosition;
+  bool isTailCalling;
+  ObjectValue tailCallee;
+  // where the arguments of the tail call start in resultVec
+  size_t tailBase;
   Object result;
   std::vector<Object> resultVec;
+  // parameters of the last declared function
+  std::vector<Param> params;
   context::Context context;
+  profile::Profiler *profiler;
+  // spans of the running code, nullptr if it was not parsed
+  const node::Spans *spans;
 };
 
 } // namespace pheonix::eval
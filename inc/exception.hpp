@@ -1,3 +1,5 @@
+#pragma once
+
 #include <cstdlib>
 #include <format>
 #include <stdexcept>
@@ -40,6 +42,12 @@ struct ParserException : public std::runtime_error {
       : std::runtime_error(std::format("{}:{}: error: {}", ln, col, msg)) {}
 };
 
-// TODO: Evaluator
+// Evaluator and VM
+// NOTE: errors raised while running are given the position of the statement
+// which raised them
+struct RuntimeException : public std::runtime_error {
+  RuntimeException(const std::string &msg, size_t ln, size_t col)
+      : std::runtime_error(std::format("{}:{}: error: {}", ln, col, msg)) {}
+};
 
 } // namespace pheonix::exception
@@ -1,19 +1,23 @@
 #pragma once
 
+#include "operator_type.hpp"
 #include "token_type.hpp"
 
 #include <map>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace pheonix::types {
 
-std::optional<token::TokenType> stringToTokenType(std::string &word);
+std::optional<token::TokenType> stringToTokenType(std::string_view word);
 
 std::string tokenTypeToLiteral(token::TokenType t);
-std::optional<token::TokenType> Keywords(const std::string &input);
+std::optional<token::TokenType> Keywords(std::string_view input);
 
-std::string opToString(const token::TokenType &tok);
+OperatorType tokenTypeToOperator(const token::TokenType &tok);
+std::string opToString(const OperatorType &op);
+CastType typeNameToCastType(const std::string &typeName);
 
 } // namespace pheonix::types
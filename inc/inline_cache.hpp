@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pheonix::eval {
+
+class ObjectValue;
+
+// Inline cache of a binary operator site, a node of the tree or a bytecode
+// instruction. It keeps the kernels of the last operand types seen there, so
+// that a hit goes straight to the kernel without the table lookup. A site
+// seeing more type pairs than there are entries keeps the latest ones.
+struct InlineCache {
+  using Kernel = ObjectValue (*)(const ObjectValue &, const ObjectValue &);
+
+  static constexpr size_t ENTRIES = 2;
+  static constexpr uint8_t EMPTY = 0xff;
+
+  // operand types are ObjectValue::Type
+  struct Entry {
+    uint8_t left = EMPTY;
+    uint8_t right = EMPTY;
+    Kernel kernel = nullptr;
+  };
+
+  Entry entries[ENTRIES];
+};
+
+// Counted over all sites, for --stats.
+struct CacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+CacheStats &cacheStats();
+
+} // namespace pheonix::eval
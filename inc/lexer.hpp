@@ -2,14 +2,22 @@
 
 #include "exception.hpp"
 #include "helpers.hpp"
+#include "source_file.hpp"
 #include "token.hpp"
 
+#include <string>
+#include <string_view>
+
 namespace pheonix::lexer {
 
 static const int IDENTIFIER_MAX_SIZE = 1200;
 static const int NUMERIC_MAX_SIZE = 1200;
 static const int STRING_MAX_SIZE = 1200;
 static const int COMMENT_MAX_SIZE = 1200;
+// a stream is read through a window of WINDOW characters, refilled so that
+// LOOKAHEAD of them follow the start of every lexem, more than the limits
+static const size_t WINDOW = 1 << 16;
+static const size_t LOOKAHEAD = 1 << 12;
 
 struct Lexem {
   token::Token token;
@@ -25,10 +33,20 @@ struct Lexer {
 private:
   void skipWhiteSpaces();
   void readChar();
+  void advance();
+  // `source` unless `stream` is given
+  Lexer(std::string_view source, std::istream *stream);
+  // NOTE: moves the characters from `from` on to the front of the window and
+  // reads the stream after them, pointers into the window are invalidated
+  void refill(const char *from);
+  // address of `ch` in the source, valid unless `ch` is EOF
+  const char *position() const { return cursor - 1; }
+  // moves to `to`, the characters skipped must not end a line
+  void jump(const char *to);
   token::Token handleOnelineCommentToken(size_t row, size_t column);
   token::Token handleMultilineCommentToken(size_t row, size_t column);
   token::Token handleNumber(size_t row, size_t column);
-  token::Token handleFloat(size_t row, size_t column, long intPart);
+  token::Token handleFloat(size_t row, size_t column, double intPart);
   token::Token handleIdentifier(size_t row, size_t column);
   token::Token handleString(size_t row, size_t column);
 
@@ -42,16 +60,26 @@ private:
   Lexem tryLiteralOrNotAToken();
 
 public:
-  Lexer(std::istream &istream)
-      : istream_(istream), offset(1), line(1), column(1) {
-    ch = istream_.get();
-    peek = istream_.peek();
-  }
+  // NOTE: the stream is read as the lexems are, it has to outlive the lexer
+  Lexer(std::istream &istream);
+  // the source is not copied, so it has to outlive the lexer
+  Lexer(std::string_view source);
+  // in place if it is mapped, read as a stream otherwise
+  Lexer(SourceFile &source);
+  Lexer(const Lexer &) = delete;
+  Lexer &operator=(const Lexer &) = delete;
 
   Lexem nextLexem();
+  // where the last lexem ends, before the white spaces following it
+  size_t currentLine() const { return line; }
+  size_t currentColumn() const { return column; }
 
 private:
-  std::istream &istream_;
+  // window on the stream, if the lexer was given one
+  std::string owned;
+  std::istream *stream;
+  const char *cursor;
+  const char *end;
   char ch;
   char peek;
   size_t offset;
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "arena.hpp"
 #include "ast_view.hpp"
+#include "helpers.hpp"
+#include "inline_cache.hpp"
+#include "operator_type.hpp"
+#include "span.hpp"
+#include "symbol.hpp"
 #include "token.hpp"
 #include "types.hpp"
 #include "visitor.hpp"
@@ -15,7 +21,19 @@ namespace pheonix::node {
 struct Node {
   virtual ~Node() = default;
   virtual void accept(visitor::Visitor &v) = 0;
-  virtual std::unique_ptr<Node> clone() const = 0;
+  // deep copy, keeping the ids
+  std::unique_ptr<Node> clone() const;
+
+  // span of the node in the Spans of its program, filled by parser::Parser
+  uint32_t id = Spans::NONE;
+
+  // NOTE: nodes created while an arena::Arena is current are placed in it,
+  // deleting them only runs destructors and the arena frees their memory
+  static void *operator new(size_t size);
+  static void operator delete(void *node, size_t size);
+
+protected:
+  virtual std::unique_ptr<Node> copy() const = 0;
 };
 
 struct Block : public Node {
@@ -24,26 +42,30 @@ struct Block : public Node {
   Block() : Node() {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct Program : public Node {
+  // owns nodes of the parsed tree, so it has to outlive `statements`, with
+  // the function bodies declared in them
+  std::shared_ptr<arena::Arena> arena;
+  std::shared_ptr<Spans> spans;
   std::vector<std::unique_ptr<Node>> statements;
 
   Program() : Node() {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct Parameter : public Node {
-  Parameter(bool isMut, const std::string &ident)
-      : Node(), isMutable(isMut), identifier(ident) {}
+  Parameter(bool isMut, symbol::Symbol s)
+      : Node(), isMutable(isMut), symbol(s) {}
   bool isMutable;
-  std::string identifier;
+  symbol::Symbol symbol;
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct DeclarationArguments : public Node {
@@ -51,30 +73,39 @@ struct DeclarationArguments : public Node {
   std::vector<std::unique_ptr<Node>> arguments;
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 // Statements
 struct FunctionDeclaration : public Node {
-  std::string identifier;
+  symbol::Symbol symbol;
   std::unique_ptr<Node> arguments;
-  std::unique_ptr<Node> statements;
+  // NOTE: shared with the functions declared from it, which do not copy it,
+  // it keeps the arena of its nodes alive, see parser::Parser::shared
+  std::shared_ptr<Node> statements;
+  // filled by resolver::Resolver
+  size_t slot;
+  std::shared_ptr<const symbol::Layout> layout;
 
-  FunctionDeclaration(std::string i) : Node(), identifier(i) {};
+  FunctionDeclaration(symbol::Symbol s)
+      : Node(), symbol(s), slot(0), layout() {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct VariableDeclaration : public Node {
   bool isMutable;
-  std::string identifier;
+  symbol::Symbol symbol;
   std::unique_ptr<Node> expression;
+  // filled by resolver::Resolver
+  size_t slot;
 
-  VariableDeclaration(bool isMut, std::string i, std::unique_ptr<Node> e)
-      : Node(), isMutable(isMut), identifier(i), expression(std::move(e)) {};
+  VariableDeclaration(bool isMut, symbol::Symbol s, std::unique_ptr<Node> e)
+      : Node(), isMutable(isMut), symbol(s), expression(std::move(e)),
+        slot(0) {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct WhileLoopStatement : public Node {
@@ -85,7 +116,7 @@ struct WhileLoopStatement : public Node {
       : Node(), expression(std::move(e)), statements(std::move(s)) {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct IfStatement : public Node {
@@ -98,7 +129,7 @@ struct IfStatement : public Node {
         elseBody(nullptr) {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct ReturnStatement : public Node {
@@ -106,7 +137,7 @@ struct ReturnStatement : public Node {
   ReturnStatement(std::unique_ptr<Node> e)
       : Node(), expression(std::move(e)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct ExpressionStatement : public Node {
@@ -114,98 +145,118 @@ struct ExpressionStatement : public Node {
   ExpressionStatement(std::unique_ptr<Node> e)
       : Node(), expression(std::move(e)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct NullStatement : public Node {
   NullStatement() : Node() {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 // Expressions
 struct AssignementExpression : public Node {
-  std::string identifier;
+  symbol::Symbol symbol;
   std::unique_ptr<Node> expression;
+  // filled by resolver::Resolver
+  size_t depth;
+  size_t slot;
 
-  AssignementExpression(std::string i, std::unique_ptr<Node> e)
-      : Node(), identifier(i), expression(std::move(e)) {};
+  AssignementExpression(symbol::Symbol s, std::unique_ptr<Node> e)
+      : Node(), symbol(s), expression(std::move(e)),
+        depth(symbol::UNRESOLVED), slot(0) {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct OrExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
-  OrExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r, std::string t)
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
+  OrExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
+               types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct AndExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
-  AndExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r, std::string t)
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
+  AndExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
+                types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct ComparisonExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
   ComparisonExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
-                       std::string t)
+                       types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct RelationalExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
   RelationalExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
-                       std::string t)
+                       types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct AdditiveExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
   AdditiveExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
-                     std::string t)
+                     types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct MultiplicativeExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
-  std::string op;
+  types::OperatorType op;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
   MultiplicativeExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r,
-                           std::string t)
+                           types::OperatorType t)
       : Node(), left(std::move(l)), right(std::move(r)), op(t) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct CompositiveExpression : public Node {
   std::unique_ptr<Node> left;
   std::unique_ptr<Node> right;
+  // filled by eval::binaryOperator
+  eval::InlineCache cache;
   CompositiveExpression(std::unique_ptr<Node> l, std::unique_ptr<Node> r)
       : Node(), left(std::move(l)), right(std::move(r)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct CastExpression : public Node {
@@ -214,25 +265,28 @@ struct CastExpression : public Node {
   CastExpression(std::unique_ptr<Node> e, std::unique_ptr<Node> t)
       : Node(), expression(std::move(e)), type(std::move(t)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct PrefixExpression : public Node {
-  std::string op;
+  types::OperatorType op;
   std::unique_ptr<Node> expression;
-  PrefixExpression(std::string o, std::unique_ptr<Node> e)
+  PrefixExpression(types::OperatorType o, std::unique_ptr<Node> e)
       : Node(), op(o), expression(std::move(e)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct CallExpression : public Node {
   std::unique_ptr<Node> function;
   std::unique_ptr<Node> arguments;
+  // filled by resolver::Resolver, the call is returned by a function body
+  bool tail;
   CallExpression(std::unique_ptr<Node> f, std::unique_ptr<Node> a)
-      : Node(), function(std::move(f)), arguments(std::move(a)) {};
+      : Node(), function(std::move(f)), arguments(std::move(a)),
+        tail(false) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct DebugExpression : public Node {
@@ -241,26 +295,33 @@ struct DebugExpression : public Node {
   DebugExpression(std::unique_ptr<Node> f, std::unique_ptr<Node> a)
       : Node(), function(std::move(f)), arguments(std::move(a)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct LambdaExpression : public Node {
   std::unique_ptr<Node> arguments;
-  std::unique_ptr<Node> statements;
+  // NOTE: shared as that of FunctionDeclaration
+  std::shared_ptr<Node> statements;
+  // filled by resolver::Resolver
+  std::shared_ptr<const symbol::Layout> layout;
 
   LambdaExpression() : Node() {};
-  LambdaExpression(std::unique_ptr<Node> a, std::unique_ptr<Node> s)
+  LambdaExpression(std::unique_ptr<Node> a, std::shared_ptr<Node> s)
       : Node(), arguments(std::move(a)), statements(std::move(s)) {};
 
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct Identifier : public Node {
-  std::string value;
-  Identifier(const std::string &val) : Node(), value(val) {};
+  symbol::Symbol symbol;
+  // filled by resolver::Resolver
+  size_t depth;
+  size_t slot;
+  Identifier(symbol::Symbol s)
+      : Node(), symbol(s), depth(symbol::UNRESOLVED), slot(0) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct ParentExpression : public Node {
@@ -268,35 +329,37 @@ struct ParentExpression : public Node {
   ParentExpression(std::unique_ptr<Node> e)
       : Node(), expression(std::move(e)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct Literal : public Node {
   Primitive value;
   Literal(Primitive val) : Node(), value(val) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct TypeSpecifier : public Node {
   std::string typeName;
-  TypeSpecifier(const std::string &t) : Node(), typeName(t) {};
+  types::CastType type;
+  TypeSpecifier(const std::string &t)
+      : Node(), typeName(t), type(types::typeNameToCastType(t)) {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 struct CallArguments : public Node {
   std::vector<std::unique_ptr<Node>> arguments;
   CallArguments() : Node() {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 // embedded function
 struct PrintFunction : public Node {
   PrintFunction() : Node() {};
   void accept(visitor::Visitor &v) override;
-  std::unique_ptr<Node> clone() const override;
+  std::unique_ptr<Node> copy() const override;
 };
 
 } // namespace pheonix::node
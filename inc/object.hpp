@@ -1,37 +1,141 @@
 #pragma once
+#include "bigint.hpp"
 #include "node.hpp"
 
+#include <concepts>
+#include <deque>
+#include <cstdint>
+
+namespace pheonix::bytecode {
+struct Chunk;
+} // namespace pheonix::bytecode
+
 namespace pheonix::eval {
 
 struct Object;
 struct Function;
-using ObjectValue =
-    std::variant<std::monostate, types::Integer, types::Float, std::string,
-                 bool, Function, std::reference_wrapper<Object>>;
+
+// A 16 byte value. Integers, floats, bools and nil are stored inline, strings,
+// integers out of 64 bits and functions are immutable and shared through
+// reference counting.
+class ObjectValue {
+public:
+  // NOTE: BIG is an `int` too, one out of 64 bits, an int which fits is
+  // always INT
+  enum class Type : uint8_t {
+    NIL = 0,
+    INT,
+    BIG,
+    FLT,
+    STR,
+    BOL,
+    FUN,
+    REF,
+    COUNT
+  };
+
+  ObjectValue();
+  ObjectValue(std::monostate);
+  ObjectValue(types::Integer value);
+  ObjectValue(types::BigInt value);
+  ObjectValue(types::Float value);
+  // NOTE: a template, so that no pointer or number is converted to bool
+  template <std::same_as<bool> B> ObjectValue(B value) : tag(Type::BOL) {
+    payload.boolean = value;
+  }
+  ObjectValue(const char *value);
+  ObjectValue(const std::string &value);
+  ObjectValue(types::String value);
+  ObjectValue(const Function &value);
+  static ObjectValue makeReference(Object &referenced);
+
+  ObjectValue(const ObjectValue &other);
+  ObjectValue(ObjectValue &&other) noexcept;
+  ObjectValue &operator=(const ObjectValue &other);
+  ObjectValue &operator=(ObjectValue &&other) noexcept;
+  ~ObjectValue();
+
+  bool operator==(const ObjectValue &other) const;
+  Type type() const { return tag; }
+
+  // NOTE: accessors expect the value to be of the matching type
+  types::Integer asInteger() const { return payload.integer; }
+  const types::BigInt &asBigInt() const { return payload.big; }
+  types::Float asFloat() const { return payload.floating; }
+  bool asBool() const { return payload.boolean; }
+  const types::String &asString() const { return payload.string; }
+  Function &asFunction() const;
+  Object &asReference() const { return *payload.reference; }
+
+private:
+  struct FunctionBox;
+
+  // NOTE: copies the payload of `other`, which has the same tag
+  void copyPayload(const ObjectValue &other);
+  void release();
+
+  union Payload {
+    int64_t integer;
+    types::BigInt big;
+    double floating;
+    bool boolean;
+    types::String string;
+    FunctionBox *function;
+    Object *reference;
+    Payload() : integer(0) {}
+    ~Payload() {}
+  } payload;
+  Type tag;
+};
 
 struct Param {
-  std::string name;
+  symbol::Symbol symbol;
   bool mut;
 };
 
+// One function of a pipeline built with `|`. The first stage gets the
+// arguments of the call, every next one the result of the previous stage.
+struct Stage {
+  std::shared_ptr<node::Node> body;
+  // frame layout of `body`, parameters take the first slots
+  std::shared_ptr<const symbol::Layout> layout;
+  // compiled `body`, used by the vm engine, filled when first needed
+  std::shared_ptr<const bytecode::Chunk> code;
+  // spans of `body`, those of the program declaring it
+  std::shared_ptr<const node::Spans> spans = nullptr;
+  // where the function was declared, for profile::Profiler
+  symbol::Symbol name = symbol::intern("lambda");
+  size_t line = 0;
+};
+
 struct Function {
   Function();
-  Function(std::unique_ptr<node::Node> b);
-  Function(const std::vector<Object> &args, std::unique_ptr<node::Node> body);
-  Function(const std::vector<Param> &args, std::unique_ptr<node::Node> b);
-  Function(const Function &other);
+  Function(std::shared_ptr<node::Node> b);
+  Function(const std::vector<Param> &args, std::shared_ptr<node::Node> b,
+           std::shared_ptr<const symbol::Layout> layout = nullptr);
+  Function(const Function &other) = default;
   bool operator==(const Function &other) const;
   Function clone() const;
-  Function &operator=(const Function &other);
+  Function &operator=(const Function &other) = default;
+
+  // pipeline running the stages of this function, then those of `next`
+  Function compose(const Function &next) const;
+  size_t stages() const { return count; }
+  Stage &stage(size_t i) const { return (*pipeline)[i]; }
 
-  // those are used for `normal` functions
+  // parameters of the first stage
   std::vector<Param> args;
-  // those are used for compisition functions
-  std::vector<Param> args2;
-  std::vector<std::unique_ptr<node::Node>> body;
+
+private:
+  // NOTE: stages are never changed once added, only appended, so every
+  // function composed from this one shares them and reads the first `count`
+  std::shared_ptr<std::deque<Stage>> pipeline;
+  size_t count;
 };
 
 std::ostream &operator<<(std::ostream &os, const Function &var);
+// the value behind references
+const ObjectValue &dereference(const ObjectValue &value);
 ObjectValue castVariants(const Primitive &p);
 std::ostream &operator<<(std::ostream &os, const ObjectValue &var);
 
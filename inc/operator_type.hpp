@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace pheonix::types {
+
+enum class OperatorType : uint8_t {
+  OR = 0,
+  AND,
+  EQUALS,
+  NEQ,
+  LESS,
+  GREATER,
+  LEQ,
+  GEQ,
+  PLUS,
+  MINUS,
+  STAR,
+  SLASH,
+  PERCENT,
+  PIPE,
+  BANG,
+  COUNT,
+};
+
+// target types of the cast operator
+enum class CastType : uint8_t {
+  INT = 0,
+  FLT,
+  STR,
+  BOL,
+  COUNT,
+};
+
+} // namespace pheonix::types
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "node.hpp"
+#include "visitor.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace pheonix::optimizer {
+
+// Rewrites the tree before it is run, keeping what every engine computes.
+//
+// Subtrees of literals are folded into a single literal with the operators
+// the engines use, unless they fail: the error is then left to be raised
+// when (and if) the expression runs. `false && e` and `true || e` are folded
+// as `e` is never evaluated. Parentheses are dropped, a cast of a value
+// which already has the target type is removed and null statements are
+// removed, except the last statement of a body, whose result is the value of
+// a call without a return.
+class Optimizer : public visitor::Visitor {
+public:
+  Optimizer();
+  void optimize(node::Node &root);
+
+  void visit(node::Program &p) override;
+  void visit(node::Parameter &p) override;
+  void visit(node::DeclarationArguments &p) override;
+  void visit(node::Block &p) override;
+  void visit(node::FunctionDeclaration &fd) override;
+  void visit(node::VariableDeclaration &vd) override;
+  void visit(node::WhileLoopStatement &wls) override;
+  void visit(node::IfStatement &wls) override;
+  void visit(node::ReturnStatement &rs) override;
+  void visit(node::ExpressionStatement &es) override;
+  void visit(node::NullStatement &ns) override;
+  void visit(node::AssignementExpression &ae) override;
+  void visit(node::OrExpression &oe) override;
+  void visit(node::AndExpression &ae) override;
+  void visit(node::ComparisonExpression &ce) override;
+  void visit(node::RelationalExpression &re) override;
+  void visit(node::MultiplicativeExpression &me) override;
+  void visit(node::CompositiveExpression &me) override;
+  void visit(node::AdditiveExpression &ae) override;
+  void visit(node::CastExpression &ce) override;
+  void visit(node::PrefixExpression &pe) override;
+  void visit(node::CallExpression &ce) override;
+  void visit(node::DebugExpression &de) override;
+  void visit(node::CallArguments &ca) override;
+  void visit(node::LambdaExpression &le) override;
+  void visit(node::Identifier &i) override;
+  void visit(node::ParentExpression &pe) override;
+  void visit(node::Literal &il) override;
+  void visit(node::TypeSpecifier &ts) override;
+  void visit(node::PrintFunction &ts) override;
+
+  // number of nodes replaced by the last optimize
+  size_t rewrites() const { return replaced; }
+
+private:
+  // optimizes `node` and puts the replacement in its place, if any
+  void optimize(std::unique_ptr<node::Node> &node);
+  void statements(std::vector<std::unique_ptr<node::Node>> &statements);
+  template <typename Binary> void binary(Binary &expression);
+  template <typename Logical>
+  void logical(Logical &expression, bool decisive);
+
+  // set by a visit when the visited node is to be replaced
+  std::unique_ptr<node::Node> replacement;
+  size_t replaced;
+};
+
+} // namespace pheonix::optimizer
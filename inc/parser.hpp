@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string_view>
 
 #include "lexer.hpp"
 #include "node.hpp"
@@ -9,6 +11,7 @@ namespace pheonix::parser {
 
 struct Parser {
 private:
+  std::unique_ptr<node::Program> newProgram();
   std::unique_ptr<node::Node> parseProgram();
   std::unique_ptr<node::Node> parseBlock();
   std::unique_ptr<node::Node> parseStatement();
@@ -46,24 +49,39 @@ private:
   std::unique_ptr<node::Node> parseCallArguments();
   std::unique_ptr<node::Node> parseLiteral();
   std::unique_ptr<node::Node> parseTypeSpecifier();
+  // a function body, which keeps the arena of the program alive
+  std::shared_ptr<node::Node> shared(std::unique_ptr<node::Node> body);
   void readLex();
+  void start();
+  // where the current lexem starts
+  node::Position position() const;
+  // records the span of `node`, from `from` to the end of the last lexem
+  template <typename N>
+  std::unique_ptr<N> spanned(std::unique_ptr<N> node, node::Position from);
 
 private:
   lexer::Lexer lexer;
   lexer::Lexem current;
   lexer::Lexem next;
+  // where `current`, `next` and the lexem before `current` end
+  node::Position currentEnd;
+  node::Position nextEnd;
+  node::Position lastEnd;
+  std::shared_ptr<node::Spans> spans;
+  std::shared_ptr<arena::Arena> arena;
 
 public:
-  Parser(std::istream &istream) : lexer(istream) {
-    do {
-      next = lexer.nextLexem();
-    } while (next.token.getTokenType() == token::TokenType::ONE_LINE_COMMENT ||
-             next.token.getTokenType() == token::TokenType::MULTILINE_COMMENT);
-    readLex();
-  };
+  Parser(std::istream &istream) : lexer(istream) { start(); };
+  // the source has to outlive the parser
+  Parser(std::string_view source) : lexer(source) { start(); };
+  // the file has to outlive the parser
+  Parser(lexer::SourceFile &source) : lexer(source) { start(); };
   void consumeIf(token::TokenType token);
   void expect(token::TokenType token);
+  // the whole source as one program
   std::unique_ptr<node::Node> generateParsingTree();
+  // the next top-level statement as a program of its own, nothing at the end
+  // of the source, for running a script while it is parsed
   std::optional<std::unique_ptr<node::Node>> parse();
 };
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "symbol.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pheonix::profile {
+
+// Profile of the script run by eval::Evaluator, for --profile.
+//
+// Calls are counted exactly. Time is sampled: a thread raises a flag every
+// `interval` and the next statement run takes the sample, charging the time
+// since the previous one to the running line, function and stack. The
+// evaluator only checks the flag between statements, so the overhead stays
+// a load per statement and a push per call.
+//
+// With a zero `interval` there is no timer, every statement, call and return
+// takes a sample, which with a `clock` of fixed ticks makes profiles exact.
+class Profiler {
+public:
+  using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+  explicit Profiler(
+      std::chrono::microseconds interval = std::chrono::milliseconds(1),
+      Clock clock = std::chrono::steady_clock::now);
+  ~Profiler();
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  // starts the timer, the script itself runs as `main`
+  void start();
+  void stop();
+
+  // hooks called by the evaluator
+  void enter(symbol::Symbol function, size_t line);
+  void leave();
+  // the running call continues with another function, a tail call or the
+  // next stage of a pipeline
+  void replace(symbol::Symbol function, size_t line);
+  // NOTE: a pending sample is taken before the line changes, the time since
+  // the previous one belongs to the statement which just ran
+  void statement(size_t line) {
+    if (pending.load(std::memory_order_relaxed))
+      sample();
+    stack.back().line = line;
+  }
+
+  // calls of the function declared at `line`
+  size_t calls(symbol::Symbol function, size_t line) const;
+  // time charged to the statements at `line` themselves
+  std::chrono::nanoseconds self(size_t line) const;
+  // functions and lines sorted by their self time
+  void report(std::ostream &os) const;
+  // one line per stack, `main:3;f:7 120` with frames labelled by the line
+  // they are running and the time in microseconds, as flamegraph.pl reads
+  void folded(std::ostream &os) const;
+
+private:
+  struct Function {
+    symbol::Symbol name;
+    // line of the declaration
+    size_t line;
+    bool operator==(const Function &other) const = default;
+  };
+  struct FunctionHash {
+    size_t operator()(const Function &f) const {
+      return f.name ^ (f.line << 32);
+    }
+  };
+  struct Counters {
+    size_t calls = 0;
+    size_t samples = 0;
+    std::chrono::nanoseconds self{0};
+    std::chrono::nanoseconds total{0};
+    // last sample which charged the total, recursive frames count once
+    size_t charged = 0;
+  };
+  struct Frame {
+    Function function;
+    Counters *counters;
+    // line of the running statement
+    size_t line;
+  };
+
+  void sample();
+  std::string label(const Function &function) const;
+
+  std::chrono::microseconds interval;
+  Clock clock;
+  std::atomic<bool> pending;
+  std::atomic<bool> running;
+  std::thread timer;
+  std::chrono::steady_clock::time_point last;
+  size_t samples;
+
+  std::vector<Frame> stack;
+  std::unordered_map<Function, Counters, FunctionHash> functions;
+  std::map<size_t, Counters> lines;
+  std::map<std::string, std::chrono::nanoseconds> stacks;
+};
+
+} // namespace pheonix::profile
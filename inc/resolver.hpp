@@ -0,0 +1,75 @@
+#pragma once
+
+#include "node.hpp"
+#include "symbol.hpp"
+#include "visitor.hpp"
+
+#include <map>
+#include <memory>
+
+namespace pheonix::resolver {
+
+// Binds names to frame slots before evaluation.
+//
+// Blocks do not open scopes, only calls push frames, so every name declared
+// in a function body (parameters, `let`, `fn`) gets a slot in its frame.
+// Top level code runs in the global frame where the slot is the symbol
+// itself. Other names get depth symbol::UNRESOLVED and, as scoping is
+// dynamic, are looked up through the symbol binding table of the Context.
+//
+// Calls returned by a function body, outside of loops, are marked as tail
+// calls; whether the caller's frame can be dropped is decided when they run.
+class Resolver : public visitor::Visitor {
+public:
+  Resolver();
+  void resolve(node::Node &root);
+
+  void visit(node::Program &p) override;
+  void visit(node::Parameter &p) override;
+  void visit(node::DeclarationArguments &p) override;
+  void visit(node::Block &p) override;
+  void visit(node::FunctionDeclaration &fd) override;
+  void visit(node::VariableDeclaration &vd) override;
+  void visit(node::WhileLoopStatement &wls) override;
+  void visit(node::IfStatement &wls) override;
+  void visit(node::ReturnStatement &rs) override;
+  void visit(node::ExpressionStatement &es) override;
+  void visit(node::NullStatement &ns) override;
+  void visit(node::AssignementExpression &ae) override;
+  void visit(node::OrExpression &oe) override;
+  void visit(node::AndExpression &ae) override;
+  void visit(node::ComparisonExpression &ce) override;
+  void visit(node::RelationalExpression &re) override;
+  void visit(node::MultiplicativeExpression &me) override;
+  void visit(node::CompositiveExpression &me) override;
+  void visit(node::AdditiveExpression &ae) override;
+  void visit(node::CastExpression &ce) override;
+  void visit(node::PrefixExpression &pe) override;
+  void visit(node::CallExpression &ce) override;
+  void visit(node::DebugExpression &de) override;
+  void visit(node::CallArguments &ca) override;
+  void visit(node::LambdaExpression &le) override;
+  void visit(node::Identifier &i) override;
+  void visit(node::ParentExpression &pe) override;
+  void visit(node::Literal &il) override;
+  void visit(node::TypeSpecifier &ts) override;
+  void visit(node::PrintFunction &ts) override;
+
+private:
+  struct Scope {
+    symbol::Layout layout;
+    std::map<symbol::Symbol, size_t> slots;
+  };
+
+  std::shared_ptr<const symbol::Layout> function(node::Node &arguments,
+                                                 node::Node &statements);
+  size_t declare(symbol::Symbol symbol);
+  void use(symbol::Symbol symbol, size_t &depth, size_t &slot);
+
+  // nullptr while resolving top level code
+  Scope *scope;
+  // loops around the current statement in the function body
+  size_t loops;
+};
+
+} // namespace pheonix::resolver
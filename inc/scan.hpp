@@ -0,0 +1,27 @@
+#pragma once
+
+namespace pheonix::lexer::scan {
+
+// Instruction sets the scanning kernels are available for.
+enum class Isa { SCALAR, SSE2, AVX2 };
+
+// best instruction set supported by the cpu, used by default
+Isa best();
+Isa current();
+// NOTE: for benchmarks and tests, `isa` must be supported by the cpu
+void use(Isa isa);
+bool supported(Isa isa);
+
+// Each kernel returns the first character of [begin, end) which does not
+// belong to the run it scans, or `end`.
+
+// run of spaces and tabs
+const char *spaces(const char *begin, const char *end);
+// run of characters which can continue an identifier
+const char *identifier(const char *begin, const char *end);
+// stops at a line break or a character read as EOF
+const char *lineEnd(const char *begin, const char *end);
+// as lineEnd, but also stops at '*', which may start the end of a comment
+const char *commentEnd(const char *begin, const char *end);
+
+} // namespace pheonix::lexer::scan
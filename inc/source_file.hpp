@@ -0,0 +1,36 @@
+#pragma once
+
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace pheonix::lexer {
+
+// Contents of a file, memory mapped where the platform allows it, so that
+// the lexer can work on them in place. Other files, such as pipes, are read
+// by the lexer as a stream, through a window of bounded size.
+class SourceFile {
+public:
+  explicit SourceFile(const std::string &path);
+  SourceFile(const SourceFile &) = delete;
+  SourceFile &operator=(const SourceFile &) = delete;
+  ~SourceFile();
+
+  // false if the file could not be read
+  explicit operator bool() const { return isOpen; }
+  // empty if the file is not mapped
+  std::string_view view() const { return {data, size}; }
+  // nullptr if the file is mapped
+  std::istream *stream() { return isMapped ? nullptr : &file; }
+
+private:
+  const char *data;
+  size_t size;
+  bool isOpen;
+  bool isMapped;
+  // read if the file is not mapped
+  std::ifstream file;
+};
+
+} // namespace pheonix::lexer
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace pheonix::node {
+
+// Place in the source, counted as lexer::Lexem counts it.
+struct Position {
+  uint32_t line = 0;
+  uint32_t column = 0;
+};
+
+std::ostream &operator<<(std::ostream &os, const Position &position);
+
+// Source of a node, from its first character to the one after its last
+// lexem.
+struct Span {
+  Position begin;
+  Position end;
+};
+
+// Spans of the nodes of a parsed program, indexed by Node::id. They are kept
+// apart from the nodes, which the engines walk, and are only read when
+// something is reported. Functions keep the spans of the program declaring
+// them, as they outlive it in the REPL.
+class Spans : public std::enable_shared_from_this<Spans> {
+public:
+  // id of the nodes without a span, e.g. those made by optimizer::Optimizer
+  static constexpr uint32_t NONE = 0;
+
+  Spans();
+  uint32_t add(const Span &span);
+  // nullptr for NONE
+  const Span *find(uint32_t id) const;
+  size_t size() const { return spans.size(); }
+
+private:
+  std::vector<Span> spans;
+};
+
+} // namespace pheonix::node
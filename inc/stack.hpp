@@ -0,0 +1,26 @@
+#pragma once
+
+#include <type_traits>
+
+namespace pheonix::stack {
+
+// Recursion of the tree walking evaluator follows the recursion of the
+// script. Once the native stack runs low, it continues on segments allocated
+// on the heap, so deep recursion is bounded by the recursion limit and not
+// by the size of the native stack.
+
+// less than a safe amount of the current stack is left
+bool low();
+// runs `function(argument)` on a new segment, exceptions are passed on
+void grow(void (*function)(void *), void *argument);
+
+template <typename F> void ensure(F &&function) {
+  if (!low()) {
+    function();
+    return;
+  }
+  using Function = std::remove_reference_t<F>;
+  grow([](void *f) { (*static_cast<Function *>(f))(); }, &function);
+}
+
+} // namespace pheonix::stack
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pheonix::types {
+
+// Value of `str`. Strings are immutable, so copies share the characters:
+// short ones are kept inline in the handle, longer ones in a reference
+// counted buffer allocated together with its header.
+//
+// A concatenation of at least ROPE characters is a rope node pointing at
+// both operands, so that `s = s + x` in a loop is linear. The characters of
+// a rope are gathered when they are first read, e.g. by print or ==, and
+// kept in the node, which then drops the operands.
+class String {
+public:
+  // characters kept inline, a byte of the handle holds their count
+  static constexpr size_t INLINE = sizeof(void *) - 1;
+  static constexpr size_t ROPE = 256;
+
+  String();
+  String(std::string_view value);
+  String(const std::string &value) : String(std::string_view(value)) {}
+  String(const char *value) : String(std::string_view(value)) {}
+  String(const String &other);
+  String(String &&other) noexcept;
+  String &operator=(const String &other);
+  String &operator=(String &&other) noexcept;
+  ~String();
+
+  static String concat(const String &lhs, const String &rhs);
+
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+  // NOTE: flattens a rope
+  const char *data() const;
+  std::string_view view() const { return {data(), size()}; }
+  operator std::string_view() const { return view(); }
+  std::string str() const { return std::string(view()); }
+
+  bool operator==(const String &other) const { return view() == other.view(); }
+  std::strong_ordering operator<=>(const String &other) const {
+    return view() <=> other.view();
+  }
+
+private:
+  struct Rep;
+
+  bool isInline() const { return bytes[TAG] & 1; }
+  Rep *rep() const;
+  void setRep(Rep *rep);
+  void release();
+  static void destroy(Rep *rep);
+  static void flatten(Rep *rep);
+
+  // NOTE: buffers are aligned, so the lowest bit of a pointer to one is
+  // clear, an inline string sets it in the byte holding that bit
+  static constexpr size_t TAG =
+      std::endian::native == std::endian::little ? 0 : sizeof(void *) - 1;
+  static constexpr size_t CHARS = TAG == 0 ? 1 : 0;
+
+  unsigned char bytes[sizeof(void *)];
+};
+
+std::ostream &operator<<(std::ostream &os, const String &string);
+
+} // namespace pheonix::types
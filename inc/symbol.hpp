@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pheonix::symbol {
+
+using Symbol = uint32_t;
+
+// NOTE: names are interned once per process, so symbols stay valid across
+// evaluators, REPL lines and engines
+Symbol intern(std::string_view name);
+const std::string &name(Symbol symbol);
+size_t count();
+
+// Shape of a function frame: symbol bound by each slot, parameters first.
+struct Layout {
+  std::vector<Symbol> symbols;
+};
+
+// Depth of names which are not bound by the frame of the current function.
+// Scoping is dynamic, so those are looked up by symbol at runtime.
+inline constexpr size_t UNRESOLVED = std::numeric_limits<size_t>::max();
+
+} // namespace pheonix::symbol
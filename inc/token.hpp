@@ -1,6 +1,9 @@
 #pragma once
 
+#include "bigint.hpp"
 #include "helpers.hpp"
+#include "string.hpp"
+#include "symbol.hpp"
 #include "token_type.hpp"
 #include "types.hpp"
 
@@ -11,8 +14,10 @@
 
 namespace pheonix {
 
+// NOTE: integer literals out of 64 bits are lexed as BigInt under the
+// PROMOTE overflow policy
 using Primitive = std::variant<std::monostate, types::Integer, types::Float,
-                               std::string, bool>;
+                               types::String, bool, types::BigInt>;
 std::ostream &operator<<(std::ostream &os, const Primitive &opt);
 
 } // namespace pheonix
@@ -20,24 +25,36 @@ std::ostream &operator<<(std::ostream &os, const Primitive &opt);
 namespace pheonix::token {
 using namespace pheonix;
 
+// NOTE: identifiers keep only their interned symbol, getValue returns its name
 struct Token {
-  Token() : tokenType(token::TokenType::NOT_A_TOKEN), value() {}
-  Token(TokenType t) : tokenType(t), value() {}
-  Token(TokenType t, const std::string &val) : tokenType(t), value(val) {}
-  Token(TokenType t, const char *val) : tokenType(t), value(std::string(val)) {}
-  Token(TokenType t, bool val) : tokenType(t), value(val) {}
-  Token(TokenType t, char val) : tokenType(t), value(std::string(1, val)) {}
-  Token(TokenType t, const types::Integer &val) : tokenType(t), value(val) {}
-  Token(TokenType t, int val) : tokenType(t), value(types::Integer(val)) {}
-  Token(TokenType t, double val) : tokenType(t), value(types::Float(val)) {}
-  Token(TokenType t, const types::Float &val) : tokenType(t), value(val) {}
+  Token() : tokenType(token::TokenType::NOT_A_TOKEN), value(), symbol(0) {}
+  Token(TokenType t) : tokenType(t), value(), symbol(0) {}
+  Token(TokenType t, const std::string &val);
+  Token(TokenType t, const char *val) : Token(t, std::string(val)) {}
+  Token(TokenType t, bool val) : tokenType(t), value(val), symbol(0) {}
+  Token(TokenType t, char val) : Token(t, std::string(1, val)) {}
+  Token(TokenType t, const types::Integer &val)
+      : tokenType(t), value(val), symbol(0) {}
+  Token(TokenType t, int val)
+      : tokenType(t), value(types::Integer(val)), symbol(0) {}
+  Token(TokenType t, int64_t val)
+      : tokenType(t), value(types::Integer(val)), symbol(0) {}
+  Token(TokenType t, double val)
+      : tokenType(t), value(types::Float(val)), symbol(0) {}
+  Token(TokenType t, const types::Float &val)
+      : tokenType(t), value(val), symbol(0) {}
+  Token(TokenType t, const types::BigInt &val)
+      : tokenType(t), value(val), symbol(0) {}
+  static Token identifier(symbol::Symbol symbol);
   bool operator==(const Token &t) const;
   token::TokenType getTokenType() const;
   Primitive getValue() const;
+  symbol::Symbol getSymbol() const;
 
 private:
   token::TokenType tokenType;
   Primitive value;
+  symbol::Symbol symbol;
 };
 std::ostream &operator<<(std::ostream &os, const Token &t);
 
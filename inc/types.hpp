@@ -1,35 +1,46 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 // #include <map>
 // #include <optional>
 
 namespace pheonix::types {
 
+// What arithmetic on Integer gives when the result does not fit in 64 bits:
+// an error, the result wrapped around or the BigInt of it
+enum class OverflowPolicy : uint8_t { TRAP, WRAP, PROMOTE };
+
+// NOTE: the policy is shared by every interpreter of the process, PROMOTE
+// by default, it decides as well whether a literal out of 64 bits is lexed
+void setOverflowPolicy(OverflowPolicy policy);
+OverflowPolicy overflowPolicy();
+
 struct Integer {
   Integer() : value(0) {}
-  Integer(int v) : value(v) {}
+  Integer(int64_t v) : value(v) {}
   Integer(const Integer &other) : value(other.value) {}
 
-  Integer &operator=(int val);
+  Integer &operator=(int64_t val);
   Integer &operator=(const Integer &val);
 
-  Integer &operator*=(int val);
-  Integer &operator/=(int val);
-  Integer &operator+=(int val);
-  Integer &operator-=(int val);
-  Integer &operator%=(int val);
+  // NOTE: operators throw when the result overflows
+  Integer &operator*=(int64_t val);
+  Integer &operator/=(int64_t val);
+  Integer &operator+=(int64_t val);
+  Integer &operator-=(int64_t val);
+  Integer &operator%=(int64_t val);
 
   Integer &operator*=(const Integer &val);
   Integer &operator/=(const Integer &val);
   Integer &operator+=(const Integer &val);
   Integer &operator-=(const Integer &val);
 
-  Integer operator*(int val) const;
-  Integer operator/(int val) const;
-  Integer operator+(int val) const;
-  Integer operator-(int val) const;
-  Integer operator%(int val) const;
+  Integer operator*(int64_t val) const;
+  Integer operator/(int64_t val) const;
+  Integer operator+(int64_t val) const;
+  Integer operator-(int64_t val) const;
+  Integer operator%(int64_t val) const;
 
   Integer operator*(const Integer &val) const;
   Integer operator/(const Integer &val) const;
@@ -37,6 +48,23 @@ struct Integer {
   Integer operator-(const Integer &val) const;
   Integer operator%(const Integer &val) const;
 
+  // checked arithmetic, true when the result overflowed, `result` is then
+  // wrapped around
+  bool addOverflow(const Integer &other, Integer &result) const {
+    return __builtin_add_overflow(value, other.value, &result.value);
+  }
+  bool subOverflow(const Integer &other, Integer &result) const {
+    return __builtin_sub_overflow(value, other.value, &result.value);
+  }
+  bool mulOverflow(const Integer &other, Integer &result) const {
+    return __builtin_mul_overflow(value, other.value, &result.value);
+  }
+  // NOTE: throws on division by zero
+  bool divOverflow(const Integer &other, Integer &result) const;
+  bool negOverflow(Integer &result) const {
+    return __builtin_sub_overflow(int64_t(0), value, &result.value);
+  }
+
   bool operator==(const Integer &other) const;
   bool operator!=(const Integer &other) const;
   bool operator<(const Integer &other) const;
@@ -46,13 +74,13 @@ struct Integer {
 
   Integer operator-() const;
 
-  int getValue() const;
-  void setValue(long val);
+  int64_t getValue() const;
+  void setValue(int64_t val);
 
   friend std::ostream &operator<<(std::ostream &os, const Integer &obj);
 
 private:
-  int value;
+  int64_t value;
 };
 
 struct Float {
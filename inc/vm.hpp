@@ -0,0 +1,52 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "context.hpp"
+#include "object.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace pheonix::vm {
+
+// Executes code produced by compiler::Compiler. Semantics follow
+// eval::Evaluator, which is kept as the reference engine.
+class VM {
+public:
+  VM();
+  VM(const context::Context &context);
+  void run(std::shared_ptr<const bytecode::Chunk> program);
+  eval::Object getResult();
+  context::Context getContext();
+  void setContext(const context::Context &con);
+  void setRecursionLimit(size_t limit);
+
+private:
+  struct Frame {
+    // the called function, nil for the program; holding the value keeps
+    // the function alive without copying it
+    eval::ObjectValue function;
+    const bytecode::Chunk *chunk;
+    size_t stage;
+    // where to continue in the caller
+    const bytecode::Instruction *returnAddress;
+    size_t stackBase;
+    bool wasDebugging;
+  };
+
+  const bytecode::Instruction *call(const bytecode::Instruction *ip,
+                                    const bytecode::Chunk &chunk);
+  bool tailCall(const eval::Function &function, size_t base,
+                const std::vector<bool> &references);
+  const bytecode::Instruction *leave();
+  eval::Object pop();
+  eval::Object &variable(const bytecode::Instruction &instruction);
+
+  bool isDebugging;
+  eval::Object result;
+  std::vector<eval::Object> stack;
+  std::vector<Frame> frames;
+  context::Context context;
+};
+
+} // namespace pheonix::vm
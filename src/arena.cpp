@@ -0,0 +1,44 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace pheonix::arena {
+
+namespace {
+
+constexpr size_t FIRST_BLOCK = 4096;
+constexpr size_t MAX_BLOCK = 1 << 20;
+
+thread_local Arena *active = nullptr;
+
+} // namespace
+
+Arena::Arena()
+    : chunks(), position(nullptr), left(0), nextSize(FIRST_BLOCK), used(0) {}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+  size_t padding = -reinterpret_cast<uintptr_t>(position) & (alignment - 1);
+  if (padding + size > left) {
+    // blocks grow, so that large inputs need only a few of them
+    size_t blockSize = std::max(nextSize, size + alignment);
+    chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(blockSize));
+    position = chunks.back().get();
+    left = blockSize;
+    nextSize = std::min(nextSize * 2, MAX_BLOCK);
+    padding = -reinterpret_cast<uintptr_t>(position) & (alignment - 1);
+  }
+  void *result = position + padding;
+  position += padding + size;
+  left -= padding + size;
+  used += size;
+  return result;
+}
+
+Arena *Arena::current() { return active; }
+
+Arena::Scope::Scope(Arena &arena) : previous(active) { active = &arena; }
+
+Arena::Scope::~Scope() { active = previous; }
+
+} // namespace pheonix::arena
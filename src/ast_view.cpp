@@ -1,4 +1,5 @@
 #include "ast_view.hpp"
+#include "helpers.hpp"
 
 #include <iomanip>
 #include <sstream>
@@ -25,7 +26,7 @@ void ASTView::visit(node::Parameter &p) {
   inc();
   result += "(Parameter:" + s +
             "isMutable=" + (p.isMutable ? "true" : "false") + "," + s +
-            "identifier=" + p.identifier + ")";
+            "identifier=" + symbol::name(p.symbol) + ")";
   dec();
 }
 
@@ -57,7 +58,7 @@ void ASTView::visit(node::Block &b) {
 
 void ASTView::visit(node::FunctionDeclaration &fd) {
   inc();
-  result += "(FunctionDeclaration:" + s + "identifier=" + fd.identifier + "," +
+  result += "(FunctionDeclaration:" + s + "identifier=" + symbol::name(fd.symbol) + "," +
             s + "arguments=";
   fd.arguments->accept(*this);
   result += "," + s + "statements=";
@@ -80,7 +81,7 @@ void ASTView::visit(node::VariableDeclaration &vd) {
   inc();
   result += "(VariableDeclaration:" + s +
             "isMutable=" + (vd.isMutable ? "true" : "false") + "," + s +
-            "identifier=" + vd.identifier + "," + s + "expression=";
+            "identifier=" + symbol::name(vd.symbol) + "," + s + "expression=";
   vd.expression->accept(*this);
   result += +")";
   dec();
@@ -124,7 +125,7 @@ void ASTView::visit(node::NullStatement &) {
 
 void ASTView::visit(node::AssignementExpression &ae) {
   inc();
-  result += "(AssignementExpression:" + s + "identifier=" + ae.identifier +
+  result += "(AssignementExpression:" + s + "identifier=" + symbol::name(ae.symbol) +
             "," + s + "expression=";
   ae.expression->accept(*this);
   result += ")";
@@ -155,7 +156,8 @@ void ASTView::visit(node::ComparisonExpression &ce) {
   inc();
   result += "(ComparisonExpression:" + s + "left=";
   ce.left->accept(*this);
-  result += "," + s + "operator=[" + ce.op + "]," + s + "right=";
+  result += "," + s + "operator=[" + types::opToString(ce.op) + "]," + s +
+            "right=";
   ce.right->accept(*this);
   result += ")";
   dec();
@@ -165,7 +167,8 @@ void ASTView::visit(node::RelationalExpression &re) {
   inc();
   result += "(RelationalExpression:" + s + "left=";
   re.left->accept(*this);
-  result += "," + s + "operator=[" + re.op + "]," + s + "right=";
+  result += "," + s + "operator=[" + types::opToString(re.op) + "]," + s +
+            "right=";
   re.right->accept(*this);
   result += ")";
   dec();
@@ -175,7 +178,8 @@ void ASTView::visit(node::MultiplicativeExpression &me) {
   inc();
   result += "(MultiplicativeExpression:" + s + "left=";
   me.left->accept(*this);
-  result += "," + s + "operator=[" + me.op + "]," + s + "right=";
+  result += "," + s + "operator=[" + types::opToString(me.op) + "]," + s +
+            "right=";
   me.right->accept(*this);
   result += ")";
   dec();
@@ -195,7 +199,8 @@ void ASTView::visit(node::AdditiveExpression &ae) {
   inc();
   result += "(AdditiveExpression:" + s + "left=";
   ae.left->accept(*this);
-  result += "," + s + "operator=[" + ae.op + "]," + s + "right=";
+  result += "," + s + "operator=[" + types::opToString(ae.op) + "]," + s +
+            "right=";
   ae.right->accept(*this);
   result += ")";
   dec();
@@ -213,8 +218,8 @@ void ASTView::visit(node::CastExpression &ce) {
 
 void ASTView::visit(node::PrefixExpression &pe) {
   inc();
-  result += "(PrefixExpression:" + s + "operator=[" + pe.op + "]," + s +
-            "expression=";
+  result += "(PrefixExpression:" + s + "operator=[" +
+            types::opToString(pe.op) + "]," + s + "expression=";
   pe.expression->accept(*this);
   result += ")";
   dec();
@@ -266,7 +271,7 @@ void ASTView::visit(node::LambdaExpression &le) {
 
 void ASTView::visit(node::Identifier &i) {
   inc();
-  result += "(Identifier:" + s + "value=" + i.value + ")";
+  result += "(Identifier:" + s + "value=" + symbol::name(i.symbol) + ")";
   dec();
 }
 
@@ -291,11 +296,15 @@ void ASTView::visit(node::Literal &il) {
              << std::get<types::Float>(il.value).getValue();
 
     result += "type=Float," + s + "value=" + dblAsStr.str();
-  } else if (std::holds_alternative<std::string>(il.value)) {
-    result += "type=String," + s + "value=" + std::get<std::string>(il.value);
+  } else if (std::holds_alternative<types::String>(il.value)) {
+    result += "type=String," + s +
+              "value=" + std::get<types::String>(il.value).str();
   } else if (std::holds_alternative<bool>(il.value)) {
     result += "type=Bool," + s +
               "value=" + (std::get<bool>(il.value) ? "true" : "false");
+  } else if (std::holds_alternative<types::BigInt>(il.value)) {
+    result += "type=Integer," + s +
+              "value=" + std::get<types::BigInt>(il.value).str();
   };
   result += ")";
   dec();
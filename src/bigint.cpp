@@ -0,0 +1,460 @@
+#include "bigint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace pheonix::types {
+
+namespace {
+
+using Limb = uint32_t;
+using Wide = uint64_t;
+using Limbs = std::vector<Limb>;
+using Span = std::span<const Limb>;
+
+constexpr int BITS = 32;
+// the largest power of ten in a limb, numbers are printed by its digits
+constexpr Limb DECIMAL = 1000000000;
+constexpr size_t DECIMAL_DIGITS = 9;
+
+// NOTE: magnitudes are kept without leading zero limbs, zero has none
+void trim(Limbs &limbs) {
+  while (!limbs.empty() && limbs.back() == 0)
+    limbs.pop_back();
+}
+
+Span trimmed(Span limbs) {
+  while (!limbs.empty() && limbs.back() == 0)
+    limbs = limbs.first(limbs.size() - 1);
+  return limbs;
+}
+
+int compare(Span lhs, Span rhs) {
+  if (lhs.size() != rhs.size())
+    return lhs.size() < rhs.size() ? -1 : 1;
+  for (size_t i = lhs.size(); i-- > 0;) {
+    if (lhs[i] != rhs[i])
+      return lhs[i] < rhs[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+Limbs add(Span lhs, Span rhs) {
+  if (lhs.size() < rhs.size())
+    std::swap(lhs, rhs);
+  Limbs result(lhs.size() + 1);
+  Wide carry = 0;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    carry += Wide(lhs[i]) + (i < rhs.size() ? rhs[i] : 0);
+    result[i] = Limb(carry);
+    carry >>= BITS;
+  }
+  result[lhs.size()] = Limb(carry);
+  trim(result);
+  return result;
+}
+
+// NOTE: expects lhs >= rhs
+Limbs subtract(Span lhs, Span rhs) {
+  Limbs result(lhs.size());
+  Wide borrow = 0;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    Wide difference = Wide(lhs[i]) - (i < rhs.size() ? rhs[i] : 0) - borrow;
+    result[i] = Limb(difference);
+    // a difference below zero wraps around, setting the highest bit
+    borrow = difference >> (2 * BITS - 1);
+  }
+  trim(result);
+  return result;
+}
+
+// adds `value` shifted by `shift` limbs to `result`, which is long enough
+// to hold the sum
+void addShifted(Limbs &result, Span value, size_t shift) {
+  Wide carry = 0;
+  size_t i = 0;
+  for (; i < value.size(); ++i) {
+    carry += Wide(result[i + shift]) + value[i];
+    result[i + shift] = Limb(carry);
+    carry >>= BITS;
+  }
+  for (i += shift; carry != 0; ++i) {
+    carry += result[i];
+    result[i] = Limb(carry);
+    carry >>= BITS;
+  }
+}
+
+Limbs schoolbook(Span lhs, Span rhs) {
+  Limbs result(lhs.size() + rhs.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    Wide carry = 0;
+    for (size_t j = 0; j < rhs.size(); ++j) {
+      // NOTE: at most (2^32 - 1)^2 + 2 * (2^32 - 1), which is 2^64 - 1
+      carry += Wide(lhs[i]) * rhs[j] + result[i + j];
+      result[i + j] = Limb(carry);
+      carry >>= BITS;
+    }
+    result[i + rhs.size()] = Limb(carry);
+  }
+  trim(result);
+  return result;
+}
+
+// lhs * rhs as (a1 B + a0)(b1 B + b0), where B is `half` limbs, by the
+// three products a0 b0, a1 b1 and (a0 + a1)(b0 + b1)
+Limbs multiply(Span lhs, Span rhs) {
+  lhs = trimmed(lhs);
+  rhs = trimmed(rhs);
+  if (lhs.size() < rhs.size())
+    std::swap(lhs, rhs);
+  if (rhs.size() < BigInt::KARATSUBA)
+    return schoolbook(lhs, rhs);
+  size_t half = lhs.size() / 2;
+  Limbs result(lhs.size() + rhs.size());
+  // a short operand is multiplied by both halves of the long one
+  if (rhs.size() <= half) {
+    addShifted(result, multiply(lhs.first(half), rhs), 0);
+    addShifted(result, multiply(lhs.subspan(half), rhs), half);
+    trim(result);
+    return result;
+  }
+  Span lhsLow = lhs.first(half), lhsHigh = lhs.subspan(half);
+  Span rhsLow = rhs.first(half), rhsHigh = rhs.subspan(half);
+  Limbs low = multiply(lhsLow, rhsLow);
+  Limbs high = multiply(lhsHigh, rhsHigh);
+  Limbs middle = multiply(add(trimmed(lhsLow), lhsHigh),
+                          add(trimmed(rhsLow), rhsHigh));
+  middle = subtract(subtract(middle, low), high);
+  addShifted(result, low, 0);
+  addShifted(result, middle, half);
+  addShifted(result, high, 2 * half);
+  trim(result);
+  return result;
+}
+
+// NOTE: `shift` is below BITS, the result has a limb more
+Limbs shiftLeft(Span limbs, int shift) {
+  Limbs result(limbs.size() + 1);
+  for (size_t i = 0; i < limbs.size(); ++i) {
+    Wide shifted = Wide(limbs[i]) << shift;
+    result[i] |= Limb(shifted);
+    result[i + 1] = Limb(shifted >> BITS);
+  }
+  return result;
+}
+
+// quotient of the division by a single limb, `remainder` gets the rest
+Limbs divideLimb(Span lhs, Limb rhs, Limb &remainder) {
+  Limbs quotient(lhs.size());
+  Wide rest = 0;
+  for (size_t i = lhs.size(); i-- > 0;) {
+    Wide current = (rest << BITS) | lhs[i];
+    quotient[i] = Limb(current / rhs);
+    rest = current % rhs;
+  }
+  trim(quotient);
+  remainder = Limb(rest);
+  return quotient;
+}
+
+// quotient and remainder of lhs / rhs, rhs is not zero
+std::pair<Limbs, Limbs> divide(Span lhs, Span rhs) {
+  if (compare(lhs, rhs) < 0)
+    return {Limbs(), Limbs(lhs.begin(), lhs.end())};
+  if (rhs.size() == 1) {
+    Limb remainder;
+    Limbs quotient = divideLimb(lhs, rhs[0], remainder);
+    Limbs rest{remainder};
+    trim(rest);
+    return {std::move(quotient), std::move(rest)};
+  }
+  // the divisor is normalized so that its highest bit is set, which keeps
+  // the estimated digits of the quotient at most 2 above the right ones
+  int shift = std::countl_zero(rhs.back());
+  Limbs divisor = shiftLeft(rhs, shift);
+  divisor.pop_back();
+  Limbs rest = shiftLeft(lhs, shift);
+  size_t n = divisor.size();
+  size_t m = rest.size() - n;
+  Limbs quotient(m);
+  for (size_t j = m; j-- > 0;) {
+    Wide numerator = (Wide(rest[j + n]) << BITS) | rest[j + n - 1];
+    Wide estimate = numerator / divisor[n - 1];
+    Wide remainder = numerator % divisor[n - 1];
+    while (estimate >> BITS ||
+           estimate * divisor[n - 2] >
+               ((remainder << BITS) | rest[j + n - 2])) {
+      --estimate;
+      remainder += divisor[n - 1];
+      if (remainder >> BITS)
+        break;
+    }
+    // rest -= estimate * divisor, shifted by j limbs
+    int64_t borrow = 0;
+    Wide carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+      Wide product = estimate * divisor[i] + carry;
+      carry = product >> BITS;
+      int64_t difference =
+          int64_t(rest[i + j]) - borrow - int64_t(Limb(product));
+      rest[i + j] = Limb(difference);
+      borrow = difference < 0;
+    }
+    int64_t difference = int64_t(rest[j + n]) - borrow - int64_t(carry);
+    rest[j + n] = Limb(difference);
+    // the estimate was one too many, the divisor is added back
+    if (difference < 0) {
+      --estimate;
+      Wide sum = 0;
+      for (size_t i = 0; i < n; ++i) {
+        sum += Wide(rest[i + j]) + divisor[i];
+        rest[i + j] = Limb(sum);
+        sum >>= BITS;
+      }
+      rest[j + n] += Limb(sum);
+    }
+    quotient[j] = Limb(estimate);
+  }
+  trim(quotient);
+  // the remainder is shifted back
+  rest.resize(n);
+  if (shift != 0) {
+    for (size_t i = 0; i < n; ++i) {
+      rest[i] >>= shift;
+      if (i + 1 < n)
+        rest[i] |= rest[i + 1] << (BITS - shift);
+    }
+  }
+  trim(rest);
+  return {std::move(quotient), std::move(rest)};
+}
+
+} // namespace
+
+// NOTE: the limbs follow the header in the same allocation
+struct BigInt::Rep {
+  uint32_t refs;
+  bool negative;
+  size_t size;
+
+  Limb *limbs() { return reinterpret_cast<Limb *>(this + 1); }
+  Span magnitude() { return {limbs(), size}; }
+
+  static Rep *make(bool negative, Limbs limbs) {
+    trim(limbs);
+    static_assert(sizeof(Rep) % alignof(Limb) == 0);
+    void *memory = ::operator new(sizeof(Rep) + limbs.size() * sizeof(Limb));
+    // NOTE: zero is never negative
+    Rep *rep =
+        new (memory) Rep{1, negative && !limbs.empty(), limbs.size()};
+    std::copy(limbs.begin(), limbs.end(), rep->limbs());
+    return rep;
+  }
+};
+
+BigInt::BigInt(int64_t value) : rep(nullptr) {
+  // NOTE: the magnitude of the minimum does not fit in int64_t
+  Wide magnitude = value < 0 ? Wide(0) - Wide(value) : Wide(value);
+  rep = Rep::make(value < 0, {Limb(magnitude), Limb(magnitude >> BITS)});
+}
+
+BigInt BigInt::fromDouble(double value) {
+  double truncated = std::trunc(value);
+  if (std::fabs(truncated) < 0x1p63)
+    return BigInt(static_cast<int64_t>(truncated));
+  // `truncated` is the 53 bit `mantissa` shifted by `exponent` - 53 bits,
+  // which is at least 11
+  int exponent;
+  double fraction = std::frexp(std::fabs(truncated), &exponent);
+  auto mantissa = static_cast<Wide>(std::ldexp(fraction, 53));
+  size_t shift = static_cast<size_t>(exponent - 53);
+  Limbs limbs(shift / BITS);
+  Limbs bits = shiftLeft(std::array<Limb, 2>{Limb(mantissa),
+                                             Limb(mantissa >> BITS)},
+                         static_cast<int>(shift % BITS));
+  limbs.insert(limbs.end(), bits.begin(), bits.end());
+  return BigInt(Rep::make(value < 0, std::move(limbs)));
+}
+
+BigInt BigInt::parse(std::string_view digits) {
+  bool negative = !digits.empty() && digits.front() == '-';
+  if (negative)
+    digits.remove_prefix(1);
+  if (digits.empty() ||
+      !std::all_of(digits.begin(), digits.end(),
+                   [](char c) { return c >= '0' && c <= '9'; }))
+    throw std::runtime_error("Invalid integer.");
+  Limbs limbs;
+  // digits are taken by DECIMAL_DIGITS, the first chunk is the shorter one
+  size_t chunk = digits.size() % DECIMAL_DIGITS;
+  if (chunk == 0)
+    chunk = DECIMAL_DIGITS;
+  for (size_t position = 0; position < digits.size();
+       position += chunk, chunk = DECIMAL_DIGITS) {
+    Limb value = 0;
+    Limb scale = 1;
+    for (char c : digits.substr(position, chunk)) {
+      value = value * 10 + Limb(c - '0');
+      scale *= 10;
+    }
+    Wide carry = value;
+    for (Limb &limb : limbs) {
+      carry += Wide(limb) * scale;
+      limb = Limb(carry);
+      carry >>= BITS;
+    }
+    if (carry != 0)
+      limbs.push_back(Limb(carry));
+  }
+  return BigInt(Rep::make(negative, std::move(limbs)));
+}
+
+BigInt::BigInt(const BigInt &other) : rep(other.rep) { ++rep->refs; }
+
+BigInt::BigInt(BigInt &&other) noexcept : rep(other.rep) {
+  other.rep = nullptr;
+}
+
+BigInt &BigInt::operator=(const BigInt &other) {
+  if (this != &other) {
+    BigInt copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+BigInt &BigInt::operator=(BigInt &&other) noexcept {
+  if (this != &other) {
+    release();
+    rep = other.rep;
+    other.rep = nullptr;
+  }
+  return *this;
+}
+
+BigInt::~BigInt() { release(); }
+
+void BigInt::release() {
+  if (rep && --rep->refs == 0)
+    ::operator delete(rep);
+  rep = nullptr;
+}
+
+BigInt operator+(const BigInt &lhs, const BigInt &rhs) {
+  Span left = lhs.rep->magnitude();
+  Span right = rhs.rep->magnitude();
+  if (lhs.rep->negative == rhs.rep->negative)
+    return BigInt(BigInt::Rep::make(lhs.rep->negative, add(left, right)));
+  // the sign is that of the operand with the larger magnitude
+  if (compare(left, right) >= 0)
+    return BigInt(
+        BigInt::Rep::make(lhs.rep->negative, subtract(left, right)));
+  return BigInt(BigInt::Rep::make(rhs.rep->negative, subtract(right, left)));
+}
+
+BigInt operator-(const BigInt &lhs, const BigInt &rhs) { return lhs + -rhs; }
+
+BigInt operator*(const BigInt &lhs, const BigInt &rhs) {
+  return BigInt(BigInt::Rep::make(
+      lhs.rep->negative != rhs.rep->negative,
+      multiply(lhs.rep->magnitude(), rhs.rep->magnitude())));
+}
+
+BigInt operator/(const BigInt &lhs, const BigInt &rhs) {
+  if (rhs.rep->size == 0)
+    throw std::runtime_error("Division by zero");
+  auto [quotient, remainder] =
+      divide(lhs.rep->magnitude(), rhs.rep->magnitude());
+  return BigInt(BigInt::Rep::make(lhs.rep->negative != rhs.rep->negative,
+                                  std::move(quotient)));
+}
+
+// NOTE: the remainder has the sign of the dividend
+BigInt operator%(const BigInt &lhs, const BigInt &rhs) {
+  if (rhs.rep->size == 0)
+    throw std::runtime_error("Modulo by zero");
+  auto [quotient, remainder] =
+      divide(lhs.rep->magnitude(), rhs.rep->magnitude());
+  return BigInt(BigInt::Rep::make(lhs.rep->negative, std::move(remainder)));
+}
+
+BigInt BigInt::operator-() const {
+  Span magnitude = rep->magnitude();
+  return BigInt(
+      Rep::make(!rep->negative, Limbs(magnitude.begin(), magnitude.end())));
+}
+
+bool BigInt::operator==(const BigInt &other) const {
+  return rep->negative == other.rep->negative &&
+         compare(rep->magnitude(), other.rep->magnitude()) == 0;
+}
+
+std::strong_ordering BigInt::operator<=>(const BigInt &other) const {
+  if (rep->negative != other.rep->negative)
+    return rep->negative ? std::strong_ordering::less
+                         : std::strong_ordering::greater;
+  int order = compare(rep->magnitude(), other.rep->magnitude());
+  if (rep->negative)
+    order = -order;
+  return order <=> 0;
+}
+
+size_t BigInt::limbs() const { return rep->size; }
+
+bool BigInt::negative() const { return rep->negative; }
+
+std::optional<int64_t> BigInt::toInteger() const {
+  if (rep->size > 2)
+    return std::nullopt;
+  Wide magnitude = 0;
+  for (size_t i = rep->size; i-- > 0;)
+    magnitude = (magnitude << BITS) | rep->limbs()[i];
+  if (!rep->negative && magnitude <= Wide(INT64_MAX))
+    return static_cast<int64_t>(magnitude);
+  if (rep->negative && magnitude <= Wide(INT64_MAX) + 1)
+    return -static_cast<int64_t>(magnitude - 1) - 1;
+  return std::nullopt;
+}
+
+double BigInt::toDouble() const {
+  double result = 0;
+  for (size_t i = rep->size; i-- > 0;)
+    result = std::ldexp(result, BITS) + rep->limbs()[i];
+  return rep->negative ? -result : result;
+}
+
+std::string BigInt::str() const {
+  if (rep->size == 0)
+    return "0";
+  // chunks of DECIMAL_DIGITS digits, the least significant first
+  std::vector<Limb> chunks;
+  Limbs rest(rep->limbs(), rep->limbs() + rep->size);
+  while (!rest.empty()) {
+    Limb chunk;
+    rest = divideLimb(rest, DECIMAL, chunk);
+    chunks.push_back(chunk);
+  }
+  std::string result = rep->negative ? "-" : "";
+  result += std::to_string(chunks.back());
+  for (size_t i = chunks.size() - 1; i-- > 0;) {
+    std::string digits = std::to_string(chunks[i]);
+    result.append(DECIMAL_DIGITS - digits.size(), '0');
+    result += digits;
+  }
+  return result;
+}
+
+std::ostream &operator<<(std::ostream &os, const BigInt &value) {
+  return os << value.str();
+}
+
+} // namespace pheonix::types
@@ -0,0 +1,81 @@
+#include "bytecode.hpp"
+
+#include <stdexcept>
+
+namespace pheonix::bytecode {
+
+size_t Chunk::emit(OpCode op, uint32_t a, uint32_t b, uint32_t c) {
+  code.push_back(Instruction{op, a, b, c});
+  nodes.push_back(statement);
+  return code.size() - 1;
+}
+
+const node::Span *Chunk::span(const Instruction *instruction) const {
+  if (!spans)
+    return nullptr;
+  return spans->find(nodes[static_cast<size_t>(instruction - code.data())]);
+}
+
+uint32_t Chunk::addConstant(const eval::Object &constant) {
+  constants.push_back(constant);
+  return static_cast<uint32_t>(constants.size() - 1);
+}
+
+std::string opCodeToString(OpCode op) {
+  switch (op) {
+  case OpCode::CONSTANT:
+    return "CONSTANT";
+  case OpCode::LOAD:
+    return "LOAD";
+  case OpCode::REFERENCE:
+    return "REFERENCE";
+  case OpCode::DECLARE:
+    return "DECLARE";
+  case OpCode::CHECK_ASSIGN:
+    return "CHECK_ASSIGN";
+  case OpCode::ASSIGN:
+    return "ASSIGN";
+  case OpCode::BINARY:
+    return "BINARY";
+  case OpCode::UNARY:
+    return "UNARY";
+  case OpCode::CAST:
+    return "CAST";
+  case OpCode::MAKE_FUNCTION:
+    return "MAKE_FUNCTION";
+  case OpCode::DEFINE_FUNCTION:
+    return "DEFINE_FUNCTION";
+  case OpCode::CALL:
+    return "CALL";
+  case OpCode::DEBUG_CALL:
+    return "DEBUG_CALL";
+  case OpCode::POP_RESULT:
+    return "POP_RESULT";
+  case OpCode::CLEAR_RESULT:
+    return "CLEAR_RESULT";
+  case OpCode::JUMP:
+    return "JUMP";
+  case OpCode::BRANCH:
+    return "BRANCH";
+  case OpCode::SHORT_CIRCUIT:
+    return "SHORT_CIRCUIT";
+  case OpCode::RETURN:
+    return "RETURN";
+  case OpCode::PRINT:
+    return "PRINT";
+  case OpCode::END:
+    return "END";
+  }
+  throw std::runtime_error("the opcode was not properly handled");
+}
+
+std::ostream &operator<<(std::ostream &os, const Chunk &chunk) {
+  for (size_t i = 0; i < chunk.code.size(); ++i) {
+    const auto &instruction = chunk.code[i];
+    os << i << ": " << opCodeToString(instruction.op) << " " << instruction.a
+       << " " << instruction.b << " " << instruction.c << "\n";
+  }
+  return os;
+}
+
+} // namespace pheonix::bytecode
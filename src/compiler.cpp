@@ -0,0 +1,282 @@
+#include "compiler.hpp"
+#include "resolver.hpp"
+
+#include <stdexcept>
+
+namespace pheonix::compiler {
+
+namespace {
+
+// Evaluator passes an argument by reference if it is a bare identifier
+node::Identifier *referenced(node::Node *argument) {
+  if (auto *identifier = dynamic_cast<node::Identifier *>(argument))
+    return identifier;
+  if (auto *parent = dynamic_cast<node::ParentExpression *>(argument))
+    return referenced(parent->expression.get());
+  return nullptr;
+}
+
+} // namespace
+
+using bytecode::OpCode;
+
+Compiler::Compiler(std::shared_ptr<const node::Spans> spans)
+    : visitor::Visitor(), chunk(), params(), spans(std::move(spans)) {}
+
+std::shared_ptr<const bytecode::Chunk> Compiler::compile(node::Node &root) {
+  chunk = std::make_shared<bytecode::Chunk>();
+  root.accept(*this);
+  chunk->emit(OpCode::END);
+  chunk->spans = spans;
+  return std::move(chunk);
+}
+
+void Compiler::visit(node::Program &p) {
+  resolver::Resolver().resolve(p);
+  spans = p.spans;
+  for (size_t i = 0; i < p.statements.size(); ++i) {
+    chunk->statement = p.statements[i]->id;
+    p.statements[i]->accept(*this);
+  }
+}
+
+void Compiler::visit(node::Parameter &p) {
+  params.emplace_back(p.symbol, p.isMutable);
+}
+
+void Compiler::visit(node::DeclarationArguments &da) {
+  params = {};
+  for (size_t i = 0; i < da.arguments.size(); ++i)
+    da.arguments[i]->accept(*this);
+}
+
+void Compiler::visit(node::Block &b) {
+  uint32_t outer = chunk->statement;
+  for (size_t i = 0; i < b.statements.size(); ++i) {
+    chunk->statement = b.statements[i]->id;
+    b.statements[i]->accept(*this);
+  }
+  chunk->statement = outer;
+}
+
+void Compiler::visit(node::FunctionDeclaration &fd) {
+  auto index = static_cast<uint32_t>(chunk->functions.size());
+  chunk->functions.push_back(
+      function(*fd.arguments, fd.statements, fd.layout));
+  chunk->emit(OpCode::DEFINE_FUNCTION, static_cast<uint32_t>(fd.slot), index);
+}
+
+void Compiler::visit(node::VariableDeclaration &vd) {
+  vd.expression->accept(*this);
+  chunk->emit(OpCode::DECLARE, static_cast<uint32_t>(vd.slot), vd.isMutable);
+}
+
+void Compiler::visit(node::WhileLoopStatement &wls) {
+  uint32_t begin = here();
+  wls.expression->accept(*this);
+  size_t branch = chunk->emit(OpCode::BRANCH);
+  wls.statements->accept(*this);
+  chunk->emit(OpCode::JUMP, begin);
+  patch(branch, here(), here());
+  chunk->emit(OpCode::CLEAR_RESULT);
+}
+
+void Compiler::visit(node::IfStatement &is) {
+  is.predicate->accept(*this);
+  size_t branch = chunk->emit(OpCode::BRANCH);
+  is.ifBody->accept(*this);
+  size_t toEnd = chunk->emit(OpCode::JUMP);
+  uint32_t onFalse = here();
+  size_t elseToEnd = 0;
+  if (is.elseBody) {
+    is.elseBody->accept(*this);
+    elseToEnd = chunk->emit(OpCode::JUMP);
+  }
+  uint32_t onNotBool = here();
+  chunk->emit(OpCode::CLEAR_RESULT);
+  patch(branch, onFalse, onNotBool);
+  patch(toEnd, here());
+  if (is.elseBody)
+    patch(elseToEnd, here());
+}
+
+void Compiler::visit(node::ReturnStatement &rs) {
+  if (rs.expression)
+    rs.expression->accept(*this);
+  else
+    chunk->emit(OpCode::CONSTANT, chunk->addConstant(eval::Object()));
+  chunk->emit(OpCode::RETURN);
+}
+
+void Compiler::visit(node::ExpressionStatement &es) {
+  es.expression->accept(*this);
+  chunk->emit(OpCode::POP_RESULT);
+}
+
+void Compiler::visit(node::NullStatement &) {
+  chunk->emit(OpCode::CLEAR_RESULT);
+}
+
+void Compiler::visit(node::AssignementExpression &ae) {
+  variable(OpCode::CHECK_ASSIGN, ae.depth, ae.slot, ae.symbol);
+  ae.expression->accept(*this);
+  variable(OpCode::ASSIGN, ae.depth, ae.slot, ae.symbol);
+}
+
+void Compiler::visit(node::OrExpression &oe) {
+  logical(*oe.left, *oe.right, oe.op, true);
+}
+
+void Compiler::visit(node::AndExpression &ae) {
+  logical(*ae.left, *ae.right, ae.op, false);
+}
+
+void Compiler::visit(node::ComparisonExpression &ce) {
+  binary(*ce.left, *ce.right, ce.op);
+}
+
+void Compiler::visit(node::RelationalExpression &re) {
+  binary(*re.left, *re.right, re.op);
+}
+
+void Compiler::visit(node::MultiplicativeExpression &me) {
+  binary(*me.left, *me.right, me.op);
+}
+
+void Compiler::visit(node::CompositiveExpression &ce) {
+  binary(*ce.left, *ce.right, types::OperatorType::PIPE);
+}
+
+void Compiler::visit(node::AdditiveExpression &ae) {
+  binary(*ae.left, *ae.right, ae.op);
+}
+
+void Compiler::visit(node::CastExpression &ce) {
+  ce.expression->accept(*this);
+  if (auto *type = dynamic_cast<node::TypeSpecifier *>(ce.type.get()))
+    chunk->emit(OpCode::CAST, static_cast<uint32_t>(type->type));
+}
+
+void Compiler::visit(node::PrefixExpression &pe) {
+  pe.expression->accept(*this);
+  chunk->emit(OpCode::UNARY, static_cast<uint32_t>(pe.op));
+}
+
+void Compiler::visit(node::CallExpression &ce) {
+  call(*ce.function, *ce.arguments, OpCode::CALL, ce.tail);
+}
+
+void Compiler::visit(node::DebugExpression &de) {
+  call(*de.function, *de.arguments, OpCode::DEBUG_CALL, de.id);
+}
+
+void Compiler::visit(node::CallArguments &ca) {
+  std::vector<bool> references;
+  for (size_t i = 0; i < ca.arguments.size(); ++i) {
+    auto *identifier = referenced(ca.arguments[i].get());
+    references.push_back(identifier != nullptr);
+    if (identifier)
+      variable(OpCode::REFERENCE, identifier->depth, identifier->slot,
+               identifier->symbol);
+    else
+      ca.arguments[i]->accept(*this);
+  }
+  chunk->callSites.push_back(std::move(references));
+}
+
+void Compiler::visit(node::LambdaExpression &le) {
+  auto index = static_cast<uint32_t>(chunk->functions.size());
+  chunk->functions.push_back(
+      function(*le.arguments, le.statements, le.layout));
+  chunk->emit(OpCode::MAKE_FUNCTION, index);
+}
+
+void Compiler::visit(node::Identifier &i) {
+  variable(OpCode::LOAD, i.depth, i.slot, i.symbol);
+}
+
+void Compiler::visit(node::ParentExpression &pe) {
+  pe.expression->accept(*this);
+}
+
+void Compiler::visit(node::Literal &l) {
+  chunk->emit(OpCode::CONSTANT, chunk->addConstant(eval::Object(l.value)));
+}
+
+void Compiler::visit(node::TypeSpecifier &ts) {
+  chunk->emit(OpCode::CONSTANT,
+              chunk->addConstant(eval::Object(Primitive(ts.typeName))));
+}
+
+void Compiler::visit(node::PrintFunction &) {
+  chunk->emit(OpCode::PRINT, symbol::intern("0"));
+}
+
+void Compiler::binary(node::Node &left, node::Node &right,
+                      types::OperatorType op) {
+  left.accept(*this);
+  right.accept(*this);
+  operation(op);
+}
+
+void Compiler::logical(node::Node &left, node::Node &right,
+                       types::OperatorType op, bool decisive) {
+  left.accept(*this);
+  size_t skip = chunk->emit(OpCode::SHORT_CIRCUIT, 0, decisive);
+  right.accept(*this);
+  operation(op);
+  patch(skip, here());
+}
+
+void Compiler::operation(types::OperatorType op) {
+  chunk->emit(OpCode::BINARY, static_cast<uint32_t>(op),
+              static_cast<uint32_t>(chunk->caches.size()));
+  chunk->caches.emplace_back();
+}
+
+void Compiler::call(node::Node &function, node::Node &arguments, OpCode op,
+                    uint32_t b) {
+  function.accept(*this);
+  arguments.accept(*this);
+  auto callSite = static_cast<uint32_t>(chunk->callSites.size() - 1);
+  chunk->emit(op, callSite, b);
+}
+
+void Compiler::variable(OpCode op, size_t depth, size_t slot,
+                        symbol::Symbol symbol) {
+  chunk->emit(op, static_cast<uint32_t>(slot), symbol, depth != 0);
+}
+
+eval::Function
+Compiler::function(node::Node &arguments,
+                   const std::shared_ptr<node::Node> &statements,
+                   std::shared_ptr<const symbol::Layout> layout) {
+  arguments.accept(*this);
+  eval::Function function(params, statements, std::move(layout));
+  function.stage(0).spans = spans;
+  function.stage(0).code = Compiler(spans).compile(*statements);
+  return function;
+}
+
+uint32_t Compiler::here() const {
+  return static_cast<uint32_t>(chunk->code.size());
+}
+
+void Compiler::patch(size_t instruction, uint32_t a) {
+  chunk->code.at(instruction).a = a;
+}
+
+void Compiler::patch(size_t instruction, uint32_t a, uint32_t b) {
+  chunk->code.at(instruction).a = a;
+  chunk->code.at(instruction).b = b;
+}
+
+void ensureCompiled(const eval::Function &function) {
+  for (size_t i = 0; i < function.stages(); ++i) {
+    eval::Stage &stage = function.stage(i);
+    if (!stage.code)
+      stage.code = Compiler(stage.spans).compile(*stage.body);
+  }
+}
+
+} // namespace pheonix::compiler
@@ -1,87 +1,328 @@
 #include "context.hpp"
 
-#include <ranges>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
 
 namespace pheonix::context {
 
-void Context::push_scope() { context.push_back({}); }
+namespace {
 
-void Context::pop_scope() {
-  if (!context.empty()) {
-    context.pop_back();
+constexpr size_t FIRST_BLOCK = 256;
+
+} // namespace
+
+Context::Context()
+    : globals(), blocks(), block(0), frames(), bindings(), shadowed(),
+      changes(), recording(false), recursionLimit(DEFAULT_RECURSION_LIMIT) {
+  frames.push_back(Frame{nullptr, 0, 0, 0, 0});
+}
+
+Context::Context(const Context &other) : Context() { *this = other; }
+
+Context &Context::operator=(const Context &other) {
+  if (this == &other)
+    return *this;
+  while (frames.size() > 1)
+    pop_frame();
+  globals = other.globals;
+  for (auto &slot : globals)
+    slot.recorded = false;
+  frames.front().size = other.frames.front().size;
+  for (size_t i = 1; i < other.frames.size(); ++i) {
+    const Frame &frame = other.frames[i];
+    std::copy(frame.base, frame.base + frame.size, pushFrame(frame.size).base);
   }
+  changes.clear();
+  recording = false;
+  recursionLimit = other.recursionLimit;
+  rebind();
+  return *this;
 }
 
-ContextIterator Context::end() { return context.back().end(); }
+void Context::push_frame(const symbol::Layout &layout) {
+  if (frames.size() > recursionLimit)
+    throw std::runtime_error("Maximum recursion depth exceeded.");
+  size_t size = layout.symbols.size();
+  Slot *base = pushFrame(size).base;
+  for (size_t i = 0; i < size; ++i) {
+    base[i].symbol = layout.symbols[i];
+    base[i].bound = false;
+  }
+}
 
-ContextIterator Context::find(const std::string &ident) {
-  for (auto &scope : std::ranges::reverse_view(context)) {
-    auto it = scope.find(ident);
-    if (it != scope.end()) {
-      return it;
-    }
+void Context::pop_frame() {
+  if (frames.size() <= 1)
+    return;
+  const Frame &frame = frames.back();
+  while (shadowed.size() > frame.mark) {
+    bindings[shadowed.back().first] = shadowed.back().second;
+    shadowed.pop_back();
   }
-  return context.back().end();
+  for (size_t i = 0; i < frame.size; ++i)
+    frame.base[i].object = eval::Object();
+  block = frame.block;
+  blocks[block].used = frame.used;
+  frames.pop_back();
 }
 
-ContextIterator Context::find_in_current_scope(const std::string &ident) {
-  auto it = context.back().find(ident);
-  if (it != context.back().end()) {
-    return it;
+size_t Context::depth() const { return frames.size(); }
+
+void Context::unwind(size_t depth) {
+  while (frames.size() > depth)
+    pop_frame();
+}
+
+void Context::replace_frame(const symbol::Layout &layout) {
+  Frame &frame = frames.back();
+  size_t size = layout.symbols.size();
+  if (!frame.base ||
+      frame.base + size > blocks[block].slots.get() + blocks[block].capacity) {
+    pop_frame();
+    push_frame(layout);
+    return;
+  }
+  Block &top = blocks[block];
+  while (shadowed.size() > frame.mark) {
+    bindings[shadowed.back().first] = shadowed.back().second;
+    shadowed.pop_back();
+  }
+  for (size_t i = 0; i < frame.size; ++i)
+    frame.base[i].object = eval::Object();
+  top.used = static_cast<size_t>(frame.base - top.slots.get()) + size;
+  frame.size = size;
+  for (size_t i = 0; i < size; ++i) {
+    frame.base[i].symbol = layout.symbols[i];
+    frame.base[i].bound = false;
   }
-  return context.back().end();
 }
 
-void Context::insert(const std::string &ident, const eval::Object &value) {
-  if (!context.empty()) {
-    auto &current_scope = context.back();
-    current_scope[ident] = value;
+bool Context::contains(size_t depth, size_t slot, symbol::Symbol symbol) const {
+  if (depth == 0 && contains_in_current_frame(slot))
+    return true;
+  return symbol < bindings.size() && bindings[symbol];
+}
+
+bool Context::contains_in_current_frame(size_t slot) const {
+  const Slot *s = findSlot(slot);
+  return s && s->bound;
+}
+
+eval::Object &Context::at(size_t depth, size_t slot, symbol::Symbol symbol) {
+  if (depth == 0)
+    return local(slot, symbol);
+  return dynamic(symbol);
+}
+
+eval::Object &Context::at_ref(size_t depth, size_t slot,
+                              symbol::Symbol symbol) {
+  eval::Object &object = at(depth, slot, symbol);
+  if (object.value.type() == eval::ObjectValue::Type::REF)
+    return object.value.asReference();
+  return object;
+}
+
+eval::Object &Context::local(size_t slot, symbol::Symbol symbol) {
+  const Frame &frame = frames.back();
+  if (slot < frame.size) {
+    Slot &s = slotIn(frame, slot);
+    if (s.bound)
+      return s.object;
+  }
+  // declared later in the frame, the binding comes from a caller
+  return dynamic(symbol);
+}
+
+eval::Object &Context::dynamic(symbol::Symbol symbol) {
+  if (symbol < bindings.size() && bindings[symbol])
+    return *bindings[symbol];
+  throw std::runtime_error("Identifier not found: " + symbol::name(symbol));
+}
+
+void Context::insert(size_t slot, const eval::Object &value) {
+  insert(slot, eval::Object(value));
+}
+
+void Context::insert(size_t slot, eval::Object &&value) {
+  Slot &s = slotAt(slot);
+  if (frames.size() == 1)
+    record(s);
+  s.object = std::move(value);
+  if (!s.bound)
+    bind(s);
+}
+
+void Context::insertRef(size_t slot, eval::Object &referenced, bool mut) {
+  insert(slot, eval::Object(eval::ObjectValue::makeReference(referenced), mut));
+}
+
+void Context::assign(size_t depth, size_t slot, symbol::Symbol symbol,
+                     const eval::ObjectValue &value) {
+  eval::Object &object = at_ref(depth, slot, symbol);
+  if (recording) {
+    // the target may be global whichever frame it was reached from
+    Slot &s = slotOf(object);
+    if (s.symbol < globals.size() && &globals[s.symbol] == &s)
+      record(s);
   }
+  object.value = value;
 }
 
+bool Context::replaceableBy(const symbol::Layout &layout,
+                            size_t parameters) const {
+  const Frame &frame = frames.back();
+  if (!frame.base)
+    return false;
+  for (size_t i = 0; i < frame.size; ++i) {
+    const Slot &slot = frame.base[i];
+    if (slot.bound && std::find(layout.symbols.begin(),
+                                layout.symbols.begin() + parameters,
+                                slot.symbol) ==
+                          layout.symbols.begin() + parameters)
+      return false;
+  }
+  return true;
+}
+
+bool Context::inCurrentFrame(const eval::Object &object) const {
+  const Frame &frame = frames.back();
+  if (!frame.base || frame.size == 0)
+    return false;
+  std::less_equal<const eval::Object *> before;
+  return before(&frame.base[0].object, &object) &&
+         before(&object, &frame.base[frame.size - 1].object);
+}
+
+void Context::setRecursionLimit(size_t limit) { recursionLimit = limit; }
+
 eval::Object &Context::at(const std::string &ident) {
-  for (auto &scope : std::ranges::reverse_view(context)) {
-    auto it = scope.find(ident);
-    if (it != scope.end()) {
-      return it->second;
-    }
+  return dynamic(symbol::intern(ident));
+}
+
+void Context::insert(const std::string &ident, const eval::Object &value) {
+  if (frames.size() != 1)
+    throw std::logic_error("Named insert outside of the global frame.");
+  insert(symbol::intern(ident), value);
+}
+
+Context Context::clone() const {
+  Context newContext(*this);
+  for (auto &slot : newContext.globals)
+    slot.object = slot.object.clone();
+  for (size_t i = 1; i < newContext.frames.size(); ++i) {
+    const Frame &frame = newContext.frames[i];
+    for (size_t j = 0; j < frame.size; ++j)
+      frame.base[j].object = frame.base[j].object.clone();
   }
-  throw std::out_of_range("Identifier not found: " + ident);
+  return newContext;
+}
+
+void Context::checkpoint() {
+  for (auto &change : changes)
+    globals[change.slot].recorded = false;
+  changes.clear();
+  recording = true;
 }
 
-eval::Object &Context::at_ref(const std::string &ident) {
-  for (auto &scope : std::ranges::reverse_view(context)) {
-    auto it = scope.find(ident);
-    if (it != scope.end()) {
-      if (std::reference_wrapper<eval::Object> *ref =
-              get_if<std::reference_wrapper<eval::Object>>(&it->second.value))
-        return ref->get();
-      return it->second;
+void Context::rollback() {
+  unwind(1);
+  for (auto change = changes.rbegin(); change != changes.rend(); ++change) {
+    Slot &slot = globals[change->slot];
+    slot.object = std::move(change->object);
+    slot.recorded = false;
+    if (slot.bound && !change->bound) {
+      // NOTE: the global frame is never popped, its entries in `shadowed`
+      // are not read again
+      slot.bound = false;
+      bindings[slot.symbol] = nullptr;
     }
   }
-  throw std::out_of_range("Identifier not found: " + ident);
+  changes.clear();
 }
 
-void Context::insertRef(const std::string &ident, const std::string &referenced,
-                        bool mut) {
-  if (!context.empty()) {
-    auto &current_scope = context.back();
-    current_scope[ident] =
-        eval::Object(eval::ObjectValue(std::ref((*this).at(referenced))), mut);
+Context::Frame &Context::pushFrame(size_t size) {
+  if (blocks.empty())
+    blocks.push_back(Block{std::make_unique<Slot[]>(FIRST_BLOCK), FIRST_BLOCK,
+                           0});
+  frames.push_back(Frame{nullptr, size, shadowed.size(), block,
+                         blocks[block].used});
+  while (blocks[block].used + size > blocks[block].capacity) {
+    // NOTE: blocks after the top one are not used by any frame
+    ++block;
+    size_t capacity = std::max(blocks[block - 1].capacity * 2, size);
+    if (block == blocks.size())
+      blocks.push_back(Block{nullptr, 0, 0});
+    if (blocks[block].capacity < size)
+      blocks[block] = Block{std::make_unique<Slot[]>(capacity), capacity, 0};
+    blocks[block].used = 0;
   }
+  Frame &frame = frames.back();
+  frame.base = blocks[block].slots.get() + blocks[block].used;
+  blocks[block].used += size;
+  return frame;
 }
-Context Context::clone() const {
-  Context newContext;
 
-  for (const auto &scope : context) {
-    std::map<std::string, eval::Object> newScope;
-    for (const auto &[ident, obj] : scope) {
-      newScope[ident] = (obj.clone());
-    }
-    newContext.context.push_back(std::move(newScope));
+Context::Slot &Context::slotIn(const Frame &frame, size_t slot) {
+  return frame.base ? frame.base[slot] : globals[slot];
+}
+
+Context::Slot &Context::slotAt(size_t slot) {
+  Frame &frame = frames.back();
+  if (slot >= frame.size) {
+    if (frames.size() != 1)
+      throw std::runtime_error("Slot out of the frame.");
+    // NOTE: only the global frame grows, it is the only frame at this point
+    for (size_t i = frame.size; i <= slot; ++i)
+      globals.push_back(Slot{eval::Object(), static_cast<symbol::Symbol>(i),
+                             false, false});
+    frame.size = slot + 1;
   }
+  return slotIn(frame, slot);
+}
 
-  return newContext;
+const Context::Slot *Context::findSlot(size_t slot) const {
+  const Frame &frame = frames.back();
+  if (slot >= frame.size)
+    return nullptr;
+  return frame.base ? &frame.base[slot] : &globals[slot];
+}
+
+void Context::bind(Slot &slot) {
+  if (slot.symbol >= bindings.size())
+    bindings.resize(symbol::count(), nullptr);
+  shadowed.emplace_back(slot.symbol, bindings[slot.symbol]);
+  bindings[slot.symbol] = &slot.object;
+  slot.bound = true;
+}
+
+void Context::record(Slot &slot) {
+  if (!recording || slot.recorded)
+    return;
+  // global slots are indexed by their symbols
+  changes.push_back(Change{slot.symbol, slot.object, slot.bound});
+  slot.recorded = true;
+}
+
+Context::Slot &Context::slotOf(eval::Object &object) {
+  static_assert(std::is_standard_layout_v<Slot> && offsetof(Slot, object) == 0);
+  // every object of the context, also one behind a reference, is in a slot
+  return reinterpret_cast<Slot &>(object);
+}
+
+void Context::rebind() {
+  bindings.assign(symbol::count(), nullptr);
+  shadowed.clear();
+  for (auto &frame : frames) {
+    frame.mark = shadowed.size();
+    for (size_t i = 0; i < frame.size; ++i) {
+      Slot &slot = slotIn(frame, i);
+      if (!slot.bound)
+        continue;
+      shadowed.emplace_back(slot.symbol, bindings[slot.symbol]);
+      bindings[slot.symbol] = &slot.object;
+    }
+  }
 }
 
 } // namespace pheonix::context
@@ -1,4 +1,7 @@
 #include "evaluator.hpp"
+#include "exception.hpp"
+#include "resolver.hpp"
+#include "stack.hpp"
 #include "token.hpp"
 #include "types.hpp"
 #include <cassert>
@@ -11,69 +14,123 @@
 
 namespace pheonix::eval {
 
-bool operator==(const ObjectValue &lhs, const ObjectValue &rhs) {
-  return std::visit([](const auto &lhs_val,
-                       const auto &rhs_val) { return lhs_val == rhs_val; },
-                    lhs, rhs);
+namespace {
+
+// the value holding the called function, found behind references
+const ObjectValue &callee(const Object &object) {
+  if (object.value.type() == ObjectValue::Type::FUN)
+    return object.value;
+  if (object.value.type() == ObjectValue::Type::REF)
+    return callee(object.value.asReference());
+  throw std::runtime_error("Called object is not a function.");
+}
+
+// NOTE: a reference in the result may point into the frame which is popped
+void detach(Object &object) { object.value = dereference(object.value); }
+
+// whether the left operand gives the result of `||` (true) or `&&` (false)
+bool decides(const ObjectValue &left, bool decisive) {
+  const ObjectValue &value = dereference(left);
+  return value.type() == ObjectValue::Type::BOL && value.asBool() == decisive;
 }
 
+// gives back the spans of the caller when a call ends, also when it fails
+struct SpansGuard {
+  const node::Spans *&spans;
+  const node::Spans *saved;
+  ~SpansGuard() { spans = saved; }
+};
+
+std::shared_ptr<const node::Spans> share(const node::Spans *spans) {
+  return spans ? spans->shared_from_this() : nullptr;
+}
+
+} // namespace
+
 Evaluator::Evaluator()
-    : visitor::Visitor(), lastName(), lastNames(), isReturning(false),
-      isDebugging(false), result(), resultVec(), context() {
+    : visitor::Visitor(), lastReference(nullptr), lastReferences(),
+      isReturning(false), isDebugging(false), inTailPosition(false),
+      isTailCalling(false), tailCallee(), tailBase(0), result(), resultVec(),
+      params(), context(), profiler(nullptr), spans(nullptr) {
   // inserting "print" function
   // NOTE: user cannot declare variable of such name
   std::vector<eval::Param> args;
-  args.emplace_back("0", false);
+  args.emplace_back(symbol::intern("0"), false);
   auto body = std::make_unique<node::PrintFunction>();
   Function f(args, std::move(body));
+  f.stage(0).name = symbol::intern("print");
 
   context.insert("print", Object(f));
 };
 
 Evaluator::Evaluator(const context::Context &context)
-    : visitor::Visitor(), lastName(), lastNames(), isReturning(false),
-      isDebugging(false), result(), resultVec(), context(context) {};
+    : visitor::Visitor(), lastReference(nullptr), lastReferences(),
+      isReturning(false), isDebugging(false), inTailPosition(false),
+      isTailCalling(false), tailCallee(), tailBase(0), result(), resultVec(),
+      params(), context(context), profiler(nullptr), spans(nullptr) {};
 
 Object Evaluator::getResult() { return Object(result); };
 std::vector<Object> Evaluator::getResultVec() { return resultVec; };
 context::Context Evaluator::getContext() { return context.clone(); }
 void Evaluator::setContext(const context::Context &con) { context = con; }
 
+void Evaluator::setRecursionLimit(size_t limit) {
+  context.setRecursionLimit(limit);
+}
+
+void Evaluator::setProfiler(profile::Profiler *profiler) {
+  this->profiler = profiler;
+}
+
+void Evaluator::checkpoint() { context.checkpoint(); }
+
+void Evaluator::rollback() {
+  context.rollback();
+  lastReference = nullptr;
+  resultVec.clear();
+  lastReferences.clear();
+  isReturning = false;
+  isDebugging = false;
+  inTailPosition = false;
+  isTailCalling = false;
+  tailCallee = ObjectValue();
+  params.clear();
+}
+
 void Evaluator::visit(node::Program &p) {
-  for (size_t i = 0; i < p.statements.size(); ++i) {
-    p.statements[i]->accept(*this);
-  }
+  resolver::Resolver().resolve(p);
+  SpansGuard restore{spans, spans};
+  spans = p.spans.get();
+  statements(p.statements, false);
 }
 void Evaluator::visit(node::Parameter &p) {
-  resultVec.emplace_back(ObjectValue(p.identifier), p.isMutable);
+  params.emplace_back(p.symbol, p.isMutable);
 }
 
 void Evaluator::visit(node::DeclarationArguments &da) {
-  resultVec = {};
+  params = {};
   for (size_t i = 0; i < da.arguments.size(); ++i) {
     da.arguments[i]->accept(*this);
   }
 }
 
-void Evaluator::visit(node::Block &b) {
-  for (size_t i = 0; i < b.statements.size(); ++i) {
-    if (!isReturning)
-      b.statements[i]->accept(*this);
-  }
-}
+void Evaluator::visit(node::Block &b) { statements(b.statements, true); }
 
 void Evaluator::visit(node::FunctionDeclaration &fd) {
   fd.arguments->accept(*this);
-  context.insert(fd.identifier,
-                 Object(Function(resultVec, fd.statements->clone())));
-  result = ObjectValue(std::monostate());
+  Function function(params, fd.statements, fd.layout);
+  function.stage(0).spans = share(spans);
+  function.stage(0).name = fd.symbol;
+  function.stage(0).line = line(fd);
+  context.insert(fd.slot, Object(function));
+  result = ObjectValue();
 }
 
 void Evaluator::visit(node::WhileLoopStatement &wls) {
   while (true) {
     wls.expression->accept(*this);
-    if (auto *predicate = std::get_if<bool>(&result.value)) {
-      if (*predicate) {
+    if (result.value.type() == ObjectValue::Type::BOL) {
+      if (result.value.asBool()) {
         wls.statements->accept(*this);
         result = Primitive(std::monostate());
         continue;
@@ -89,9 +146,9 @@ void Evaluator::visit(node::WhileLoopStatement &wls) {
 
 void Evaluator::visit(node::VariableDeclaration &vd) {
   vd.expression->accept(*this);
-  if (context.find_in_current_scope(vd.identifier) == context.end()) {
+  if (!context.contains_in_current_frame(vd.slot)) {
     result.mut = vd.isMutable;
-    context.insert(vd.identifier, result);
+    context.insert(vd.slot, result);
     return;
   }
   throw std::runtime_error("Redeclaration of variable");
@@ -99,8 +156,8 @@ void Evaluator::visit(node::VariableDeclaration &vd) {
 
 void Evaluator::visit(node::IfStatement &is) {
   is.predicate->accept(*this);
-  if (auto *predicate = std::get_if<bool>(&result.value)) {
-    if (*predicate) {
+  if (result.value.type() == ObjectValue::Type::BOL) {
+    if (result.value.asBool()) {
       is.ifBody->accept(*this);
       return;
     }
@@ -130,210 +187,315 @@ void Evaluator::visit(node::ExpressionStatement &es) {
 void Evaluator::visit(node::NullStatement &) { result = Primitive(); }
 
 void Evaluator::visit(node::AssignementExpression &ae) {
-  if (context.find(ae.identifier) == context.end()) {
+  if (!context.contains(ae.depth, ae.slot, ae.symbol)) {
     throw std::runtime_error("variable was not declared");
     return;
   }
-  if (!context.at(ae.identifier).mut) {
+  if (!context.at(ae.depth, ae.slot, ae.symbol).mut) {
     throw std::runtime_error("variable is not mutable.");
     return;
   }
 
   ae.expression->accept(*this);
-  context.at_ref(ae.identifier).value = result.value;
+  context.assign(ae.depth, ae.slot, ae.symbol, result.value);
   return;
 }
 
+// NOTE: the right side is evaluated only if the left one does not decide
+// the result, operands which are not bools still fail in binaryOperator
 void Evaluator::visit(node::OrExpression &oe) {
   oe.left->accept(*this);
-  auto left = result.value;
+  if (decides(result.value, true)) {
+    result = ObjectValue(true);
+    lastReference = nullptr;
+    return;
+  }
+  auto left = std::move(result.value);
   oe.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(oe.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, oe.op, oe.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::AndExpression &ae) {
   ae.left->accept(*this);
-  auto left = result.value;
+  if (decides(result.value, false)) {
+    result = ObjectValue(false);
+    lastReference = nullptr;
+    return;
+  }
+  auto left = std::move(result.value);
   ae.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(ae.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, ae.op, ae.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::ComparisonExpression &ce) {
   ce.left->accept(*this);
-  auto left = result.value;
+  auto left = std::move(result.value);
   ce.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(ce.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, ce.op, ce.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::RelationalExpression &re) {
   re.left->accept(*this);
-  auto left = result.value;
+  auto left = std::move(result.value);
   re.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(re.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, re.op, re.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::MultiplicativeExpression &me) {
   me.left->accept(*this);
-  auto left = result.value;
+  auto left = std::move(result.value);
   me.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(me.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, me.op, me.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::CompositiveExpression &me) {
   me.left->accept(*this);
-  auto left = result.value;
+  auto left = std::move(result.value);
   me.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>("|"));
-  lastName = "";
+  result = binaryOperator(left, result.value, types::OperatorType::PIPE,
+                          me.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::AdditiveExpression &ae) {
   ae.left->accept(*this);
-  auto left = result.value;
+  auto left = std::move(result.value);
   ae.right->accept(*this);
-  auto right = result.value;
-  result = std::visit(OperatorVisitor{}, left, right,
-                      std::variant<std::string>(ae.op));
-  lastName = "";
+  result = binaryOperator(left, result.value, ae.op, ae.cache);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::CastExpression &ce) {
   ce.expression->accept(*this);
-  if (ce.type) {
-    auto expression = result.value;
-    ce.type->accept(*this);
-    auto type = result.value;
-    result = std::visit(OperatorVisitor{}, expression, type,
-                        std::variant<std::string>("<-"));
-    lastName = "";
+  if (auto *type = dynamic_cast<node::TypeSpecifier *>(ce.type.get())) {
+    result = castOperator(result.value, type->type);
+    lastReference = nullptr;
     return;
   }
 }
 
 void Evaluator::visit(node::PrefixExpression &pe) {
   pe.expression->accept(*this);
-  auto expression = result.value;
-  result = std::visit(OperatorVisitor{}, expression,
-                      std::variant<std::string>(pe.op));
-  lastName = "";
+  result = prefixOperator(result.value, pe.op);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::CallExpression &ce) {
   bool curIsReturning = isReturning;
   isReturning = false;
-  context.push_scope();
   ce.function->accept(*this);
-  auto function = std::get<Function>(result.value);
+  // NOTE: a copy of the value keeps the function alive while it runs
+  ObjectValue called = callee(result);
+  size_t base = resultVec.size();
   ce.arguments->accept(*this);
-  assert(resultVec.size() == lastNames.size());
-  assert(resultVec.size() == function.args.size());
-  for (size_t i = 0; i < resultVec.size(); ++i) {
-    // for (size_t i = 0; i < function.args.size(); ++i) {
-    if (lastNames[i] != "") {
-      if ((function.args.at(i).mut) && (!context.at(lastNames.at(i)).mut))
-        throw std::runtime_error("variable is not mutable.");
-      context.insertRef(function.args.at(i).name, lastNames.at(i),
-                        function.args.at(i).mut);
-    }
-
-    // function.args.at(i).mut  );
-    else
-      context.insert(function.args.at(i).name, resultVec.at(i));
-  }
-  function.body.at(0)->accept(*this);
-  // if it is a composite function
-  for (size_t i = 1; i < function.body.size(); ++i) {
-    context.pop_scope();
-    context.push_scope();
-    context.insert(function.args2.at(i - 1).name, result);
-    isReturning = false;
-    function.body.at(i)->accept(*this);
-  }
-  context.pop_scope();
+  assert(resultVec.size() == lastReferences.size());
+  if (!ce.tail || !tailCall(called, base))
+    call(std::move(called), base);
   isReturning = curIsReturning;
-  lastName = "";
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::DebugExpression &de) {
-  lastName = "";
+  lastReference = nullptr;
   // tragedy ...
   bool curIsReturning = isReturning;
   isReturning = false;
   bool curIsDebugging = isDebugging;
   isDebugging = true;
-  context.push_scope();
   de.function->accept(*this);
-  auto function = std::get<Function>(result.value);
+  const ObjectValue called = callee(result);
+  const Function &function = called.asFunction();
+  size_t base = resultVec.size();
   de.arguments->accept(*this);
-  std::cout << "[input: ";
-  for (size_t i = 0; i < resultVec.size(); ++i) {
-    if (lastNames.at(i) != "") {
-      std::cout << context.at(lastNames.at(i)).value;
-      context.insertRef(function.args.at(i).name, lastNames.at(i),
-                        function.args.at(i).mut);
+  if (resultVec.size() - base != function.args.size())
+    throw std::runtime_error("Wrong number of arguments.");
+  context.push_frame(*function.stage(0).layout);
+  if (profiler)
+    profiler->enter(function.stage(0).name, function.stage(0).line);
+  std::cout << "[input";
+  if (const node::Span *span = spans ? spans->find(de.id) : nullptr)
+    std::cout << " at " << span->begin;
+  std::cout << ": ";
+  for (size_t i = 0; i < resultVec.size() - base; ++i) {
+    if (Object *reference = lastReferences.at(base + i)) {
+      std::cout << reference->value;
+      context.insertRef(i, *reference, function.args.at(i).mut);
 
     } else {
-      std::cout << resultVec.at(i).value;
-      context.insert(function.args.at(i).name, resultVec.at(i));
+      std::cout << resultVec.at(base + i).value;
+      context.insert(i, resultVec.at(base + i));
     }
-    if (i < resultVec.size() - 1)
+    if (base + i < resultVec.size() - 1)
       std::cout << ", ";
   }
   std::cout << "]\n";
-  function.body.at(0)->accept(*this);
-  // if it is a composite function
-  for (size_t i = 1; i < function.body.size(); ++i) {
-    context.pop_scope();
-    context.push_scope();
-    context.insert(function.args2.at(i - 1).name, result);
+  resultVec.resize(base);
+  lastReferences.resize(base);
+  SpansGuard restore{spans, spans};
+  spans = function.stage(0).spans.get();
+  function.stage(0).body->accept(*this);
+  for (size_t i = 1; i < function.stages(); ++i) {
+    nextStage(function.stage(i));
     isReturning = false;
     isDebugging = true;
-    function.body.at(i)->accept(*this);
+    function.stage(i).body->accept(*this);
   }
-  context.pop_scope();
+  detach(result);
+  context.pop_frame();
+  if (profiler)
+    profiler->leave();
   isReturning = curIsReturning;
   isDebugging = curIsDebugging;
 }
 
+// NOTE: the try block costs nothing until something is thrown
+void Evaluator::statements(
+    const std::vector<std::unique_ptr<node::Node>> &statements, bool body) {
+  size_t i = 0;
+  try {
+    for (; i < statements.size() && !(body && isReturning); ++i) {
+      if (profiler)
+        profiler->statement(line(*statements[i]));
+      statements[i]->accept(*this);
+    }
+  } catch (const exception::RuntimeException &) {
+    throw;
+  } catch (const std::runtime_error &error) {
+    const node::Span *span = spans ? spans->find(statements[i]->id) : nullptr;
+    if (!span)
+      throw;
+    throw exception::RuntimeException(error.what(), span->begin.line,
+                                      span->begin.column);
+  }
+}
+
+size_t Evaluator::line(const node::Node &node) const {
+  const node::Span *span = spans ? spans->find(node.id) : nullptr;
+  return span ? span->begin.line : 0;
+}
+
+void Evaluator::call(ObjectValue called, size_t base) {
+  bool wasInTailPosition = inTailPosition;
+  if (profiler)
+    profiler->enter(called.asFunction().stage(0).name,
+                    called.asFunction().stage(0).line);
+  SpansGuard restore{spans, spans};
+  stack::ensure([&] {
+    enter(called.asFunction(), base);
+    while (true) {
+      const Function &function = called.asFunction();
+      spans = function.stage(0).spans.get();
+      for (size_t i = 0; i < function.stages(); ++i) {
+        if (i > 0)
+          nextStage(function.stage(i));
+        isReturning = false;
+        inTailPosition = i + 1 == function.stages();
+        function.stage(i).body->accept(*this);
+      }
+      if (!isTailCalling)
+        break;
+      isTailCalling = false;
+      called = std::move(tailCallee);
+      context.pop_frame();
+      enter(called.asFunction(), tailBase);
+      if (profiler)
+        profiler->replace(called.asFunction().stage(0).name,
+                          called.asFunction().stage(0).line);
+    }
+  });
+  detach(result);
+  context.pop_frame();
+  if (profiler)
+    profiler->leave();
+  inTailPosition = wasInTailPosition;
+}
+
+void Evaluator::enter(const Function &function, size_t base) {
+  if (resultVec.size() - base != function.args.size())
+    throw std::runtime_error("Wrong number of arguments.");
+  // NOTE: arguments are resolved in the caller frame
+  context.push_frame(*function.stage(0).layout);
+  for (size_t i = 0; i < resultVec.size() - base; ++i) {
+    Object *reference = lastReferences[base + i];
+    if (reference) {
+      if ((function.args.at(i).mut) && (!reference->mut))
+        throw std::runtime_error("variable is not mutable.");
+      context.insertRef(i, *reference, function.args.at(i).mut);
+    } else
+      context.insert(i, std::move(resultVec[base + i]));
+  }
+  resultVec.resize(base);
+  lastReferences.resize(base);
+}
+
+// NOTE: the result of a stage of a pipeline is passed to the next one in
+// the same frame
+void Evaluator::nextStage(const Stage &stage) {
+  detach(result);
+  context.replace_frame(*stage.layout);
+  context.insert(0, result);
+  spans = stage.spans.get();
+  if (profiler)
+    profiler->replace(stage.name, stage.line);
+}
+
+bool Evaluator::tailCall(const ObjectValue &called, size_t base) {
+  const Function &function = called.asFunction();
+  size_t count = resultVec.size() - base;
+  if (!inTailPosition || isDebugging || count != function.args.size() ||
+      !context.replaceableBy(*function.stage(0).layout, count))
+    return false;
+  // arguments referring to the replaced frame are passed by value, which
+  // nobody can tell apart once the frame is gone, unless they are
+  // references themselves
+  for (size_t i = 0; i < count; ++i) {
+    Object *reference = lastReferences[base + i];
+    if (reference && context.inCurrentFrame(*reference) &&
+        (reference->value.type() == ObjectValue::Type::REF ||
+         (function.args[i].mut && !reference->mut)))
+      return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    Object *reference = lastReferences[base + i];
+    if (reference && context.inCurrentFrame(*reference)) {
+      resultVec[base + i] = Object(reference->value, function.args[i].mut);
+      lastReferences[base + i] = nullptr;
+    }
+  }
+  // NOTE: the arguments stay pushed, the running call takes them
+  tailCallee = called;
+  tailBase = base;
+  isTailCalling = true;
+  return true;
+}
+
 void Evaluator::visit(node::CallArguments &ca) {
-  resultVec = {};
-  lastNames = {};
-  auto cVec = resultVec;
-  auto cNam = lastNames;
+  // NOTE: arguments are pushed, the caller takes them off when they are in
+  // the frame, so that arguments which are calls themselves keep them apart
   for (size_t i = 0; i < ca.arguments.size(); ++i) {
     ca.arguments[i]->accept(*this);
-    cVec.push_back(result);
-    cNam.push_back(lastName);
+    resultVec.push_back(std::move(result));
+    lastReferences.push_back(lastReference);
   }
-  resultVec = cVec;
-  lastNames = cNam;
 }
 
 void Evaluator::visit(node::LambdaExpression &le) {
   le.arguments->accept(*this);
-  result = Object(Function(resultVec, le.statements->clone()));
+  Function function(params, le.statements, le.layout);
+  function.stage(0).spans = share(spans);
+  function.stage(0).line = line(le);
+  result = Object(function);
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::Identifier &i) {
-  result = context.at(i.value);
-  lastName = i.value;
+  lastReference = &context.at(i.depth, i.slot, i.symbol);
+  result = *lastReference;
 }
 
 void Evaluator::visit(node::ParentExpression &pe) {
@@ -342,7 +504,7 @@ void Evaluator::visit(node::ParentExpression &pe) {
 
 void Evaluator::visit(node::Literal &l) {
   result = l.value;
-  lastName = "";
+  lastReference = nullptr;
 }
 
 void Evaluator::visit(node::TypeSpecifier &ts) {
@@ -350,7 +512,10 @@ void Evaluator::visit(node::TypeSpecifier &ts) {
 }
 
 void Evaluator::visit([[maybe_unused]] node::PrintFunction &pf) {
-  std::cout << context.at("0").value << "\n";
+  static const symbol::Symbol argument = symbol::intern("0");
+  // NOTE: the argument is the result, as it was moved out of `result`
+  result = context.local(0, argument);
+  std::cout << result.value << "\n";
 }
 
 } // namespace pheonix::eval
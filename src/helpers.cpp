@@ -104,7 +104,7 @@ std::string tokenTypeToLiteral(token::TokenType t) {
   throw std::runtime_error("the token was not properly handled");
 }
 
-std::optional<token::TokenType> Keywords(const std::string &input) {
+std::optional<token::TokenType> Keywords(std::string_view input) {
   if (input == "fn")
     return token::TokenType::FN;
   if (input == "let")
@@ -134,7 +134,7 @@ std::optional<token::TokenType> Keywords(const std::string &input) {
   return {};
 }
 
-std::optional<token::TokenType> stringToTokenType(std::string &word) {
+std::optional<token::TokenType> stringToTokenType(std::string_view word) {
   auto token = types::Keywords(word);
   if (token.has_value()) {
     return token.value();
@@ -142,46 +142,90 @@ std::optional<token::TokenType> stringToTokenType(std::string &word) {
   return {};
 }
 
-std::string opToString(const token::TokenType &tok) {
+OperatorType tokenTypeToOperator(const token::TokenType &tok) {
   switch (tok) {
+  case token::TokenType::OR:
+    return OperatorType::OR;
+  case token::TokenType::AND:
+    return OperatorType::AND;
   case token::TokenType::EQUALS:
-    return "==";
-    break;
+    return OperatorType::EQUALS;
   case token::TokenType::NEQ:
-    return "!=";
-    break;
+    return OperatorType::NEQ;
   case token::TokenType::PLUS:
-    return "+";
-    break;
+    return OperatorType::PLUS;
   case token::TokenType::MINUS:
-    return "-";
-    break;
+    return OperatorType::MINUS;
   case token::TokenType::BANG:
-    return "!";
-    break;
+    return OperatorType::BANG;
   case token::TokenType::STAR:
-    return "*";
-    break;
+    return OperatorType::STAR;
   case token::TokenType::SLASH:
-    return "/";
-    break;
+    return OperatorType::SLASH;
   case token::TokenType::PERCENT:
-    return "%";
-    break;
+    return OperatorType::PERCENT;
   case token::TokenType::LEQ:
-    return "<=";
-    break;
+    return OperatorType::LEQ;
   case token::TokenType::LESS:
-    return "<";
-    break;
+    return OperatorType::LESS;
   case token::TokenType::GEQ:
-    return ">=";
-    break;
+    return OperatorType::GEQ;
   case token::TokenType::GREATER:
+    return OperatorType::GREATER;
+  case token::TokenType::PIPE:
+    return OperatorType::PIPE;
+  default:
+    throw std::runtime_error("the token is not an operator");
+  }
+}
+
+std::string opToString(const OperatorType &op) {
+  switch (op) {
+  case OperatorType::OR:
+    return "||";
+  case OperatorType::AND:
+    return "&&";
+  case OperatorType::EQUALS:
+    return "==";
+  case OperatorType::NEQ:
+    return "!=";
+  case OperatorType::LESS:
+    return "<";
+  case OperatorType::GREATER:
     return ">";
-    break;
+  case OperatorType::LEQ:
+    return "<=";
+  case OperatorType::GEQ:
+    return ">=";
+  case OperatorType::PLUS:
+    return "+";
+  case OperatorType::MINUS:
+    return "-";
+  case OperatorType::STAR:
+    return "*";
+  case OperatorType::SLASH:
+    return "/";
+  case OperatorType::PERCENT:
+    return "%";
+  case OperatorType::PIPE:
+    return "|";
+  case OperatorType::BANG:
+    return "!";
   default:
     return "";
   }
 }
+
+CastType typeNameToCastType(const std::string &typeName) {
+  if (typeName == "INT")
+    return CastType::INT;
+  if (typeName == "FLT")
+    return CastType::FLT;
+  if (typeName == "STR")
+    return CastType::STR;
+  if (typeName == "BOL")
+    return CastType::BOL;
+  throw std::runtime_error("the type name is not a cast target");
+}
+
 } // namespace pheonix::types
@@ -1,8 +1,13 @@
 #include "lexer.hpp"
+#include "scan.hpp"
+
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <string>
@@ -27,8 +32,26 @@ std::ostream &operator<<(std::ostream &os, const Lexem &l) {
   return os;
 }
 
+Lexer::Lexer(std::istream &istream) : Lexer(std::string_view(), &istream) {}
+
+Lexer::Lexer(std::string_view source) : Lexer(source, nullptr) {}
+
+Lexer::Lexer(SourceFile &source) : Lexer(source.view(), source.stream()) {}
+
+Lexer::Lexer(std::string_view source, std::istream *stream)
+    : owned(stream ? WINDOW : 0, '\0'), stream(stream),
+      cursor(stream ? owned.data() : source.data()),
+      end(stream ? owned.data() : source.data() + source.size()), offset(1),
+      line(1), column(1) {
+  advance();
+}
+
 Lexem Lexer::nextLexem() {
   skipWhiteSpaces();
+  // NOTE: a lexem within the limits is then whole in the window, the scans
+  // over it need not refill
+  if (stream && ch != EOF && static_cast<size_t>(end - position()) < LOOKAHEAD)
+    refill(position());
   if (auto result = tryEndOfFile())
     return result.value();
   if (auto result = trySlashOrToken())
@@ -235,8 +258,7 @@ void Lexer::readChar() {
     if (peek == '\n') {
       // Windows
       ++offset;
-      ch = istream_.get();
-      peek = istream_.peek();
+      advance();
     }
     ++line;
     column = 0;
@@ -246,17 +268,46 @@ void Lexer::readChar() {
     peek = ch;
     return;
   }
-  ch = istream_.get();
-  peek = istream_.peek();
+  advance();
   ++offset;
   ++column;
 }
 
+void Lexer::advance() {
+  if (cursor == end)
+    refill(cursor);
+  ch = cursor != end ? *cursor++ : static_cast<char>(EOF);
+  if (cursor == end && ch != static_cast<char>(EOF))
+    refill(position());
+  peek = cursor != end ? *cursor : static_cast<char>(EOF);
+}
+
+void Lexer::refill(const char *from) {
+  if (!stream || !*stream)
+    return;
+  size_t kept = static_cast<size_t>(end - from);
+  size_t shift = static_cast<size_t>(from - owned.data());
+  std::memmove(owned.data(), from, kept);
+  cursor -= shift;
+  stream->read(owned.data() + kept, static_cast<std::streamsize>(WINDOW - kept));
+  end = owned.data() + kept + stream->gcount();
+}
+
+void Lexer::jump(const char *to) {
+  size_t skipped = static_cast<size_t>(to - position());
+  offset += skipped;
+  column += skipped;
+  cursor = to;
+  advance();
+}
+
 void Lexer::skipWhiteSpaces() {
   while (true) {
     switch (ch) {
     case ' ':
     case '\t':
+      jump(scan::spaces(position() + 1, end));
+      break;
     case '\n':
     case '\r':
       readChar();
@@ -268,26 +319,16 @@ void Lexer::skipWhiteSpaces() {
 }
 
 token::Token Lexer::handleOnelineCommentToken(size_t row, size_t column) {
-  std::string buffer = "";
-  buffer += ch;
+  const char *start = position();
+  const char *stop = scan::lineEnd(start, end);
+  if (static_cast<size_t>(stop - start) > COMMENT_MAX_SIZE)
+    throw exception::OneLineCommentTooLong(row, column);
+  std::string buffer(start, stop);
+  jump(stop);
+  if (ch == '\r' && peek == '\n')
+    readChar();
   readChar();
-  while (buffer.size() <= COMMENT_MAX_SIZE) {
-    switch (ch) {
-    case '\r':
-      if (peek == '\n')
-        readChar();
-      [[fallthrough]];
-    case '\n':
-    case EOF:
-      readChar();
-      return token::Token(token::TokenType::ONE_LINE_COMMENT, buffer);
-      break;
-    default:
-      buffer += ch;
-      readChar();
-    }
-  }
-  throw exception::OneLineCommentTooLong(row, column);
+  return token::Token(token::TokenType::ONE_LINE_COMMENT, buffer);
 }
 
 token::Token Lexer::handleMultilineCommentToken(size_t row, size_t column) {
@@ -317,54 +358,83 @@ token::Token Lexer::handleMultilineCommentToken(size_t row, size_t column) {
       break;
     case EOF:
       throw exception::UnfinishedMultilineComment(row, column);
-    default:
+    case '\n':
+    case '\r':
       buffer += ch;
       readChar();
+      break;
+    default: {
+      // everything up to a possible end of the comment is taken at once
+      const char *start = position();
+      size_t room = COMMENT_MAX_SIZE + 1 - buffer.size();
+      const char *limit = start + std::min<size_t>(end - start, room);
+      const char *stop = scan::commentEnd(start + 1, limit);
+      buffer.append(start, stop);
+      jump(stop);
+    }
     }
   }
   throw exception::MultilineCommentTooLong(row, column);
 }
 
 token::Token Lexer::handleIdentifier(size_t row, size_t column) {
-  std::string buffer = "";
-  buffer += ch;
-  readChar();
-  while ((isalnum(ch) || ch == '_') && buffer.size() <= IDENTIFIER_MAX_SIZE) {
-    buffer += ch;
-    readChar();
-  }
-  if (buffer.size() > IDENTIFIER_MAX_SIZE)
+  const char *start = position();
+  const char *stop = scan::identifier(start + 1, end);
+  if (static_cast<size_t>(stop - start) > IDENTIFIER_MAX_SIZE)
     throw exception::LexerException("Identifier too long.", row, column);
+  std::string_view word(start, static_cast<size_t>(stop - start));
 
-  if (auto result = types::stringToTokenType(buffer)) {
+  // NOTE: the word is read before the jump, which may refill the window
+  token::Token token;
+  if (auto result = types::stringToTokenType(word)) {
     if (result == token::TokenType::TRUE)
-      return token::Token(*result, true);
-    if (result == token::TokenType::FALSE)
-      return token::Token(*result, false);
-    return token::Token(*result);
+      token = token::Token(*result, true);
+    else if (result == token::TokenType::FALSE)
+      token = token::Token(*result, false);
+    else
+      token = token::Token(*result);
+  } else {
+    token = token::Token::identifier(symbol::intern(word));
   }
-
-  return token::Token(token::TokenType::IDENTIFIER, buffer);
+  jump(stop);
+  return token;
 }
 
 token::Token Lexer::handleNumber(size_t row, size_t column) {
-  types::Integer integerPart;
+  int64_t integerPart = 0;
+  // NOTE: the digits are kept only once they are out of 64 bits
+  std::string digits;
 
   while (isdigit(ch)) {
-    integerPart = integerPart * 10 + static_cast<long>(ch - '0');
+    int64_t next;
+    if (!digits.empty())
+      digits += ch;
+    else if (__builtin_mul_overflow(integerPart, 10, &next) ||
+             __builtin_add_overflow(next, ch - '0', &next))
+      digits = std::to_string(integerPart) + ch;
+    else
+      integerPart = next;
     readChar();
   }
   if (ch == '.') {
     readChar();
-    return handleFloat(row, column, integerPart.getValue());
+    return handleFloat(row, column,
+                       digits.empty() ? static_cast<double>(integerPart)
+                                      : types::BigInt::parse(digits).toDouble());
   }
   if (isalpha(ch))
     throw exception::LexerException("Undefined value.", row, column);
 
-  return token::Token(token::TokenType::INTEGER, integerPart);
+  if (digits.empty())
+    return token::Token(token::TokenType::INTEGER,
+                        types::Integer(integerPart));
+  if (types::overflowPolicy() != types::OverflowPolicy::PROMOTE)
+    throw exception::LexerException("Integer literal out of range.", row,
+                                    column);
+  return token::Token(token::TokenType::INTEGER, types::BigInt::parse(digits));
 }
 
-token::Token Lexer::handleFloat(size_t row, size_t column, long intPart) {
+token::Token Lexer::handleFloat(size_t row, size_t column, double intPart) {
   int fractionalPart = 0;
   int length = 0;
 
@@ -376,7 +446,7 @@ token::Token Lexer::handleFloat(size_t row, size_t column, long intPart) {
   if (isalpha(ch))
     throw exception::LexerException("Undefined value.", row, column);
 
-  double result = static_cast<double>(intPart) +
+  double result = intPart +
                   static_cast<double>(fractionalPart) *
                       std::pow(10., static_cast<double>(-length));
   return token::Token(token::TokenType::FLOAT, result);
@@ -411,8 +481,21 @@ token::Token Lexer::handleString(size_t line, size_t column) {
       readChar();
       continue;
     }
-    buffer += ch;
-    readChar();
+    if (ch == '\n' || ch == '\r') {
+      buffer += ch;
+      readChar();
+      continue;
+    }
+    // a run of plain characters is taken at once
+    const char *start = position();
+    const char *stop = start + 1;
+    size_t room = STRING_MAX_SIZE + 1 - buffer.size();
+    const char *limit = start + std::min<size_t>(end - start, room);
+    while (stop != limit && *stop != '"' && *stop != '\\' &&
+           *stop != '\n' && *stop != '\r' && *stop != static_cast<char>(EOF))
+      ++stop;
+    buffer.append(start, stop);
+    jump(stop);
   }
 
   if (ch == '"' && buffer.size() <= STRING_MAX_SIZE) {
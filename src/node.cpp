@@ -1,8 +1,42 @@
 #include "node.hpp"
 #include "visitor.hpp"
 
+#include <new>
+
 namespace pheonix::node {
 
+namespace {
+
+// Every node is preceded by a header telling where it was allocated.
+struct alignas(std::max_align_t) Header {
+  bool inArena;
+};
+
+} // namespace
+
+void *Node::operator new(size_t size) {
+  void *memory;
+  auto *arena = arena::Arena::current();
+  if (arena)
+    memory = arena->allocate(sizeof(Header) + size, alignof(Header));
+  else
+    memory = ::operator new(sizeof(Header) + size);
+  auto *header = new (memory) Header{arena != nullptr};
+  return header + 1;
+}
+
+void Node::operator delete(void *node, size_t size) {
+  auto *header = static_cast<Header *>(node) - 1;
+  if (!header->inArena)
+    ::operator delete(header, sizeof(Header) + size);
+}
+
+std::unique_ptr<Node> Node::clone() const {
+  auto node = copy();
+  node->id = id;
+  return node;
+}
+
 void Program::accept(visitor::Visitor &v) { v.visit(*this); }
 void Parameter::accept(visitor::Visitor &v) { v.visit(*this); }
 void DeclarationArguments::accept(visitor::Visitor &v) { v.visit(*this); }
@@ -34,49 +68,54 @@ void Literal::accept(visitor::Visitor &v) { v.visit(*this); }
 void TypeSpecifier::accept(visitor::Visitor &v) { v.visit(*this); }
 void PrintFunction::accept(visitor::Visitor &v) { v.visit(*this); }
 
-std::unique_ptr<Node> Program::clone() const {
+std::unique_ptr<Node> Program::copy() const {
   auto program = std::make_unique<Program>();
+  program->spans = spans;
   for (size_t i = 0; i < this->statements.size(); ++i)
     program->statements.push_back(this->statements[i]->clone());
   return program;
 }
 
-std::unique_ptr<Node> Parameter::clone() const {
-  return std::make_unique<Parameter>(this->isMutable, this->identifier);
+std::unique_ptr<Node> Parameter::copy() const {
+  return std::make_unique<Parameter>(this->isMutable, this->symbol);
 }
 
-std::unique_ptr<Node> DeclarationArguments::clone() const {
+std::unique_ptr<Node> DeclarationArguments::copy() const {
   auto declArgs = std::make_unique<DeclarationArguments>();
   for (size_t i = 0; i < this->arguments.size(); ++i)
     declArgs->arguments.push_back(this->arguments[i]->clone());
   return declArgs;
 }
 
-std::unique_ptr<Node> Block::clone() const {
+std::unique_ptr<Node> Block::copy() const {
   auto block = std::make_unique<Block>();
   for (size_t i = 0; i < this->statements.size(); ++i)
     block->statements.push_back(this->statements[i]->clone());
   return block;
 }
 
-std::unique_ptr<Node> FunctionDeclaration::clone() const {
-  auto fn = std::make_unique<FunctionDeclaration>(this->identifier);
+std::unique_ptr<Node> FunctionDeclaration::copy() const {
+  auto fn = std::make_unique<FunctionDeclaration>(this->symbol);
   fn->statements = this->statements->clone();
   fn->arguments = this->arguments->clone();
+  fn->slot = this->slot;
+  fn->layout = this->layout;
   return fn;
 }
 
-std::unique_ptr<Node> VariableDeclaration::clone() const {
-  return std::make_unique<VariableDeclaration>(
-      this->isMutable, this->identifier, this->expression->clone());
+std::unique_ptr<Node> VariableDeclaration::copy() const {
+  auto vd = std::make_unique<VariableDeclaration>(
+      this->isMutable, this->symbol, this->expression->clone());
+  vd->slot = this->slot;
+  return vd;
 }
 
-std::unique_ptr<Node> WhileLoopStatement::clone() const {
+std::unique_ptr<Node> WhileLoopStatement::copy() const {
   return std::make_unique<WhileLoopStatement>(this->expression->clone(),
                                               this->statements->clone());
 }
 
-std::unique_ptr<Node> IfStatement::clone() const {
+std::unique_ptr<Node> IfStatement::copy() const {
   auto ifStmt = std::make_unique<IfStatement>(this->predicate->clone());
   ifStmt->ifBody = this->ifBody->clone();
   if (this->elseBody)
@@ -84,113 +123,123 @@ std::unique_ptr<Node> IfStatement::clone() const {
   return ifStmt;
 }
 
-std::unique_ptr<Node> ReturnStatement::clone() const {
+std::unique_ptr<Node> ReturnStatement::copy() const {
   return std::make_unique<ReturnStatement>(this->expression->clone());
 }
 
-std::unique_ptr<Node> ExpressionStatement::clone() const {
+std::unique_ptr<Node> ExpressionStatement::copy() const {
   return std::make_unique<ExpressionStatement>(this->expression->clone());
 }
 
-std::unique_ptr<Node> NullStatement::clone() const {
+std::unique_ptr<Node> NullStatement::copy() const {
   return std::make_unique<NullStatement>();
 }
 
-std::unique_ptr<Node> AssignementExpression::clone() const {
-  return std::make_unique<AssignementExpression>(this->identifier,
-                                                 this->expression->clone());
+std::unique_ptr<Node> AssignementExpression::copy() const {
+  auto ae = std::make_unique<AssignementExpression>(this->symbol,
+                                                    this->expression->clone());
+  ae->depth = this->depth;
+  ae->slot = this->slot;
+  return ae;
 }
 
-std::unique_ptr<Node> OrExpression::clone() const {
+std::unique_ptr<Node> OrExpression::copy() const {
   return std::make_unique<OrExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> AndExpression::clone() const {
+std::unique_ptr<Node> AndExpression::copy() const {
   return std::make_unique<AndExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> ComparisonExpression::clone() const {
+std::unique_ptr<Node> ComparisonExpression::copy() const {
   return std::make_unique<ComparisonExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> RelationalExpression::clone() const {
+std::unique_ptr<Node> RelationalExpression::copy() const {
   return std::make_unique<RelationalExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> AdditiveExpression::clone() const {
+std::unique_ptr<Node> AdditiveExpression::copy() const {
   return std::make_unique<AdditiveExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> MultiplicativeExpression::clone() const {
+std::unique_ptr<Node> MultiplicativeExpression::copy() const {
   return std::make_unique<MultiplicativeExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr),
       this->op);
 }
 
-std::unique_ptr<Node> CompositiveExpression::clone() const {
+std::unique_ptr<Node> CompositiveExpression::copy() const {
   return std::make_unique<CompositiveExpression>(
       this->left->clone(), (this->right ? this->right->clone() : nullptr));
 }
 
-std::unique_ptr<Node> CastExpression::clone() const {
+std::unique_ptr<Node> CastExpression::copy() const {
   return std::make_unique<CastExpression>(this->expression->clone(),
                                           this->type->clone());
 }
 
-std::unique_ptr<Node> PrefixExpression::clone() const {
+std::unique_ptr<Node> PrefixExpression::copy() const {
   return std::make_unique<PrefixExpression>(this->op,
                                             this->expression->clone());
 }
 
-std::unique_ptr<Node> CallExpression::clone() const {
-  return std::make_unique<CallExpression>(this->function->clone(),
-                                          this->arguments->clone());
+std::unique_ptr<Node> CallExpression::copy() const {
+  auto call = std::make_unique<CallExpression>(this->function->clone(),
+                                               this->arguments->clone());
+  call->tail = this->tail;
+  return call;
 }
 
-std::unique_ptr<Node> DebugExpression::clone() const {
+std::unique_ptr<Node> DebugExpression::copy() const {
   return std::make_unique<DebugExpression>(this->function->clone(),
                                            this->arguments->clone());
 }
 
-std::unique_ptr<Node> CallArguments::clone() const {
+std::unique_ptr<Node> CallArguments::copy() const {
   auto arguments = std::make_unique<CallArguments>();
   for (size_t i = 0; i < this->arguments.size(); ++i)
     arguments->arguments.push_back(this->arguments[i]->clone());
   return arguments;
 }
 
-std::unique_ptr<Node> LambdaExpression::clone() const {
-  return std::make_unique<LambdaExpression>(this->arguments->clone(),
-                                            this->statements->clone());
+std::unique_ptr<Node> LambdaExpression::copy() const {
+  auto le = std::make_unique<LambdaExpression>(this->arguments->clone(),
+                                               this->statements->clone());
+  le->layout = this->layout;
+  return le;
 }
 
-std::unique_ptr<Node> Identifier::clone() const {
-  return std::make_unique<Identifier>(this->value);
+std::unique_ptr<Node> Identifier::copy() const {
+  auto identifier = std::make_unique<Identifier>(this->symbol);
+  identifier->depth = this->depth;
+  identifier->slot = this->slot;
+  return identifier;
 }
 
-std::unique_ptr<Node> ParentExpression::clone() const {
+std::unique_ptr<Node> ParentExpression::copy() const {
   return std::make_unique<ParentExpression>(this->expression->clone());
 }
 
-std::unique_ptr<Node> Literal::clone() const {
+std::unique_ptr<Node> Literal::copy() const {
   return std::make_unique<Literal>(this->value);
 }
 
-std::unique_ptr<Node> TypeSpecifier::clone() const {
+std::unique_ptr<Node> TypeSpecifier::copy() const {
   return std::make_unique<TypeSpecifier>(this->typeName);
 }
 
-std::unique_ptr<Node> PrintFunction::clone() const {
+std::unique_ptr<Node> PrintFunction::copy() const {
   return std::make_unique<PrintFunction>();
 }
 
@@ -1,38 +1,51 @@
 #include "object.hpp"
 
+#include <cstring>
+
 namespace pheonix::eval {
 
-Function::Function() : body() {}
+Function::Function() : args(), pipeline(), count(0) {}
 
-Function::Function(std::unique_ptr<node::Node> b) : body() {
-  body.push_back(std::move(b));
+Function::Function(std::shared_ptr<node::Node> b)
+    : args(), pipeline(std::make_shared<std::deque<Stage>>()), count(1) {
+  pipeline->push_back(
+      Stage{std::move(b), std::make_shared<const symbol::Layout>(), nullptr});
 }
 
-Function::Function(const std::vector<Param> &args,
-                   std::unique_ptr<node::Node> b)
-    : args(args), body() {
-  body.push_back(std::move(b));
-}
+namespace {
 
-Function::Function(const Function &other) {
-  args = other.args;
-  args2 = other.args2;
-  for (const auto &node : other.body) {
-    body.push_back(node->clone());
-  }
+std::shared_ptr<const symbol::Layout>
+parametersLayout(const std::vector<Param> &args) {
+  auto layout = std::make_shared<symbol::Layout>();
+  for (const auto &arg : args)
+    layout->symbols.push_back(arg.symbol);
+  return layout;
 }
 
-Function::Function(const std::vector<Object> &arguments,
-                   std::unique_ptr<node::Node> b)
-    : args({}), body() {
-  body.emplace_back(std::move(b));
+} // namespace
+
+Function::Function(const std::vector<Param> &args,
+                   std::shared_ptr<node::Node> b,
+                   std::shared_ptr<const symbol::Layout> layout)
+    : args(args), pipeline(std::make_shared<std::deque<Stage>>()), count(1) {
+  pipeline->push_back(
+      Stage{std::move(b), layout ? std::move(layout) : parametersLayout(args),
+            nullptr});
+}
 
-  for (size_t i = 0; i < arguments.size(); ++i) {
-    if (!std::holds_alternative<std::string>(arguments[i].value))
-      throw std::runtime_error("");
-    args.emplace_back(std::get<std::string>(arguments[i].value),
-                      arguments[i].mut);
+Function Function::compose(const Function &next) const {
+  Function result(*this);
+  // another composition already appended to the shared stages
+  if (!pipeline || pipeline->size() != count) {
+    result.pipeline = std::make_shared<std::deque<Stage>>();
+    for (size_t i = 0; i < count; ++i)
+      result.pipeline->push_back(stage(i));
   }
+  // NOTE: `next` may share the stages too, a deque keeps them in place
+  for (size_t i = 0; i < next.count; ++i)
+    result.pipeline->push_back(next.stage(i));
+  result.count += next.count;
+  return result;
 }
 
 bool Function::operator==(const Function &other) const {
@@ -40,33 +53,137 @@ bool Function::operator==(const Function &other) const {
   return true;
 }
 
-Function Function::clone() const {
-  Function temp;
-  temp.args = args;
-  temp.args2 = args2;
-  for (const auto &node : body) {
-    temp.body.push_back(node->clone());
+Function Function::clone() const { return *this; }
+
+std::ostream &operator<<(std::ostream &os, const Function &var) {
+  auto args = std::string('_', var.args.size());
+  os << "Function(" << args << ")";
+  return os;
+}
+
+struct ObjectValue::FunctionBox {
+  uint32_t refs;
+  Function value;
+};
+
+static_assert(sizeof(ObjectValue) == 16);
+
+ObjectValue::ObjectValue() : tag(Type::NIL) {}
+
+ObjectValue::ObjectValue(std::monostate) : ObjectValue() {}
+
+ObjectValue::ObjectValue(types::Integer value) : tag(Type::INT) {
+  payload.integer = value.getValue();
+}
+
+ObjectValue::ObjectValue(types::BigInt value) : tag(Type::BIG) {
+  new (&payload.big) types::BigInt(std::move(value));
+}
+
+ObjectValue::ObjectValue(types::Float value) : tag(Type::FLT) {
+  payload.floating = value.getValue();
+}
+
+ObjectValue::ObjectValue(const char *value)
+    : ObjectValue(types::String(value)) {}
+
+ObjectValue::ObjectValue(const std::string &value)
+    : ObjectValue(types::String(value)) {}
+
+ObjectValue::ObjectValue(types::String value) : tag(Type::STR) {
+  new (&payload.string) types::String(std::move(value));
+}
+
+ObjectValue::ObjectValue(const Function &value) : tag(Type::FUN) {
+  payload.function = new FunctionBox{1, value};
+}
+
+ObjectValue ObjectValue::makeReference(Object &referenced) {
+  ObjectValue value;
+  value.tag = Type::REF;
+  value.payload.reference = &referenced;
+  return value;
+}
+
+ObjectValue::ObjectValue(const ObjectValue &other) : tag(other.tag) {
+  copyPayload(other);
+}
+
+// NOTE: no payload points into itself, so moving any payload is
+// copying its bytes, the moved from value is left without destroying it
+ObjectValue::ObjectValue(ObjectValue &&other) noexcept : tag(other.tag) {
+  std::memcpy(static_cast<void *>(&payload), &other.payload, sizeof(Payload));
+  other.tag = Type::NIL;
+}
+
+ObjectValue &ObjectValue::operator=(const ObjectValue &other) {
+  if (this != &other) {
+    ObjectValue copy(other);
+    *this = std::move(copy);
   }
-  return temp;
+  return *this;
 }
 
-Function &Function::operator=(const Function &other) {
-  args = other.args;
-  args2 = other.args2;
+ObjectValue &ObjectValue::operator=(ObjectValue &&other) noexcept {
   if (this != &other) {
-    body.clear();
-    if (!other.body.empty()) {
-      for (const auto &node : other.body)
-        body.push_back(node->clone());
-    }
+    release();
+    std::memcpy(static_cast<void *>(&payload), &other.payload,
+                sizeof(Payload));
+    tag = other.tag;
+    other.tag = Type::NIL;
   }
   return *this;
 }
 
-std::ostream &operator<<(std::ostream &os, const Function &var) {
-  auto args = std::string('_', var.args.size());
-  os << "Function(" << args << ")";
-  return os;
+ObjectValue::~ObjectValue() { release(); }
+
+bool ObjectValue::operator==(const ObjectValue &other) const {
+  if (tag != other.tag)
+    return false;
+  switch (tag) {
+  case Type::INT:
+    return payload.integer == other.payload.integer;
+  case Type::BIG:
+    return asBigInt() == other.asBigInt();
+  case Type::FLT:
+    return asFloat() == other.asFloat();
+  case Type::STR:
+    return asString() == other.asString();
+  case Type::BOL:
+    return payload.boolean == other.payload.boolean;
+  case Type::FUN:
+    return asFunction() == other.asFunction();
+  case Type::REF:
+    return asReference().value == other.asReference().value;
+  default:
+    return true;
+  }
+}
+
+Function &ObjectValue::asFunction() const { return payload.function->value; }
+
+void ObjectValue::copyPayload(const ObjectValue &other) {
+  if (tag == Type::STR) {
+    new (&payload.string) types::String(other.payload.string);
+    return;
+  }
+  if (tag == Type::BIG) {
+    new (&payload.big) types::BigInt(other.payload.big);
+    return;
+  }
+  std::memcpy(static_cast<void *>(&payload), &other.payload, sizeof(Payload));
+  if (tag == Type::FUN)
+    ++payload.function->refs;
+}
+
+void ObjectValue::release() {
+  if (tag == Type::STR)
+    payload.string.~String();
+  else if (tag == Type::BIG)
+    payload.big.~BigInt();
+  else if (tag == Type::FUN && --payload.function->refs == 0)
+    delete payload.function;
+  tag = Type::NIL;
 }
 
 ObjectValue castVariants(const Primitive &p) {
@@ -74,44 +191,58 @@ ObjectValue castVariants(const Primitive &p) {
     return std::get<types::Integer>(p);
   if (std::holds_alternative<types::Float>(p))
     return std::get<types::Float>(p);
-  if (std::holds_alternative<std::string>(p))
-    return std::get<std::string>(p);
+  if (std::holds_alternative<types::String>(p))
+    return std::get<types::String>(p);
   if (std::holds_alternative<bool>(p))
     return std::get<bool>(p);
+  if (std::holds_alternative<types::BigInt>(p))
+    return std::get<types::BigInt>(p);
   return std::monostate();
 }
 
 std::ostream &operator<<(std::ostream &os, const ObjectValue &var) {
-  std::visit(
-      [&os](const auto &value) {
-        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, bool>) {
-          os << (value ? "true" : "false");
-        } else if constexpr (std::is_same_v<std::decay_t<decltype(value)>,
-                                            std::reference_wrapper<Object>>) {
-          os << value.get().value;
-        } else {
-          os << value;
-        }
-      },
-      var);
+  switch (var.type()) {
+  case ObjectValue::Type::INT:
+    os << var.asInteger();
+    break;
+  case ObjectValue::Type::BIG:
+    os << var.asBigInt();
+    break;
+  case ObjectValue::Type::FLT:
+    os << var.asFloat();
+    break;
+  case ObjectValue::Type::STR:
+    os << var.asString();
+    break;
+  case ObjectValue::Type::BOL:
+    os << (var.asBool() ? "true" : "false");
+    break;
+  case ObjectValue::Type::FUN:
+    os << var.asFunction();
+    break;
+  case ObjectValue::Type::REF:
+    os << var.asReference().value;
+    break;
+  default:
+    os << "[]";
+  }
   return os;
 }
 
-Object::Object() : value(std::monostate{}), mut(false) {}
+const ObjectValue &dereference(const ObjectValue &value) {
+  const ObjectValue *current = &value;
+  while (current->type() == ObjectValue::Type::REF)
+    current = &current->asReference().value;
+  return *current;
+}
+
+Object::Object() : value(), mut(false) {}
 
 Object::Object(const Primitive &p, bool mut)
     : value(castVariants(p)), mut(mut) {}
 
 Object::Object(const ObjectValue &p, bool mut) : value(p), mut(mut) {}
 
-Object Object::clone() const {
-  if (std::holds_alternative<Function>(value)) {
-    if (!std::get<Function>(value).body.empty()) {
-      return Object(std::get<Function>(value).clone(), mut);
-    }
-    return Object(Function(), mut);
-  }
-  return Object(value, mut);
-}
+Object Object::clone() const { return Object(value, mut); }
 
 } // namespace pheonix::eval
@@ -1,182 +1,384 @@
 #include "operator_visitor.hpp"
 
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
 namespace pheonix::eval {
 
-// infix operators
-ObjectValue OperatorVisitor::operator()(const types::Integer &lhs,
-                                        const types::Integer &rhs,
-                                        const std::string &op) const {
-  // arithmetic
-  if (op == "+")
-    return lhs + rhs;
-  else if (op == "-")
-    return lhs - rhs;
-  else if (op == "*")
-    return lhs * rhs;
-  else if (op == "/")
-    return lhs / rhs;
-  else if (op == "%")
-    return lhs % rhs;
-  // comparison
-  else if (op == "==")
-    return bool(lhs == rhs);
-  else if (op == "!=")
-    return bool(lhs != rhs);
-  else if (op == "<")
-    return lhs < rhs;
-  else if (op == ">")
-    return (lhs > rhs);
-  else if (op == "<=")
-    return (lhs <= rhs);
-  else if (op == ">=")
-    return bool(lhs >= rhs);
+namespace {
+
+using types::CastType;
+using types::OperatorType;
+
+using Binary = ObjectValue (*)(const ObjectValue &, const ObjectValue &);
+using Unary = ObjectValue (*)(const ObjectValue &);
+
+constexpr size_t TYPES = static_cast<size_t>(ObjectValue::Type::COUNT);
+constexpr size_t OPERATORS = static_cast<size_t>(OperatorType::COUNT);
+constexpr size_t CASTS = static_cast<size_t>(CastType::COUNT);
+
+template <typename T> constexpr size_t typeIndex() {
+  using Type = ObjectValue::Type;
+  if constexpr (std::is_same_v<T, types::Integer>)
+    return static_cast<size_t>(Type::INT);
+  else if constexpr (std::is_same_v<T, types::BigInt>)
+    return static_cast<size_t>(Type::BIG);
+  else if constexpr (std::is_same_v<T, types::Float>)
+    return static_cast<size_t>(Type::FLT);
+  else if constexpr (std::is_same_v<T, types::String>)
+    return static_cast<size_t>(Type::STR);
+  else if constexpr (std::is_same_v<T, bool>)
+    return static_cast<size_t>(Type::BOL);
   else
-    throw std::runtime_error("Invalid transition");
+    return static_cast<size_t>(Type::FUN);
 }
 
-ObjectValue OperatorVisitor::operator()(const types::Float &lhs,
-                                        const types::Float &rhs,
-                                        const std::string &op) const {
-  // arithmetic
-  if (op == "+")
-    return lhs + rhs;
-  else if (op == "-")
-    return lhs - rhs;
-  else if (op == "*")
-    return lhs * rhs;
-  else if (op == "/")
-    return lhs / rhs;
-  // comparison
-  else if (op == "==")
-    return lhs == rhs;
-  else if (op == "!=")
-    return lhs != rhs;
-  else if (op == "<")
-    return lhs < rhs;
-  else if (op == ">")
-    return lhs > rhs;
-  else if (op == "<=")
-    return lhs <= rhs;
-  else if (op == ">=")
-    return lhs >= rhs;
+template <typename T> decltype(auto) payload(const ObjectValue &value) {
+  if constexpr (std::is_same_v<T, types::Integer>)
+    return value.asInteger();
+  else if constexpr (std::is_same_v<T, types::BigInt>)
+    return value.asBigInt();
+  else if constexpr (std::is_same_v<T, types::Float>)
+    return value.asFloat();
+  else if constexpr (std::is_same_v<T, types::String>)
+    return value.asString();
+  else if constexpr (std::is_same_v<T, bool>)
+    return value.asBool();
   else
-    throw std::runtime_error("Invalid transition");
+    return value.asFunction();
 }
 
-ObjectValue OperatorVisitor::operator()(bool lhs, bool rhs,
-                                        const std::string &op) const {
-  if (op == "&&")
-    return lhs && rhs;
-  else if (op == "||")
-    return lhs || rhs;
-  else
-    throw std::runtime_error("Invalid transition");
+ObjectValue identity(const ObjectValue &exp) { return exp; }
+
+ObjectValue invalidBinary(const ObjectValue &, const ObjectValue &) {
+  throw std::runtime_error("Invalid transition");
 }
 
-ObjectValue OperatorVisitor::operator()(const std::string &lhs,
-                                        const std::string &rhs,
-                                        const std::string &op) const {
-  if (op == "+")
-    return lhs + rhs;
-  // cast operator
-  if ((op == "<-") && (rhs == "STR"))
-    return lhs;
-  else
-    throw std::runtime_error("Invalid transition");
+ObjectValue invalidUnary(const ObjectValue &) {
+  throw std::runtime_error("Invalid transition");
 }
 
-// cast operator
-ObjectValue OperatorVisitor::operator()(types::Integer lhs,
-                                        const std::string &rhs,
-                                        const std::string &op) const {
-  if ((op == "<-") && (rhs == "INT"))
-    return lhs;
-  if ((op == "<-") && (rhs == "STR"))
-    return std::to_string(lhs.getValue());
-  if ((op == "<-") && (rhs == "FLT"))
-    return types::Float(lhs.getValue());
-  if ((op == "<-") && (rhs == "BOL"))
-    return lhs.getValue() != 0;
-  else
-    throw std::runtime_error("Invalid transition");
+// NOTE: kernels get operands of the alternatives they were registered for
+template <typename L, typename R, typename F>
+ObjectValue binaryKernel(const ObjectValue &lhs, const ObjectValue &rhs) {
+  return F{}(payload<L>(lhs), payload<R>(rhs));
 }
 
-ObjectValue OperatorVisitor::operator()(types::Float lhs,
-                                        const std::string &rhs,
-                                        const std::string &op) const {
-  if ((op == "<-") && (rhs == "INT"))
-    return types::Integer(static_cast<int>(lhs.getValue()));
-  if ((op == "<-") && (rhs == "STR"))
-    return std::to_string(lhs.getValue());
-  if ((op == "<-") && (rhs == "FLT"))
-    return lhs;
-  else
-    throw std::runtime_error("Invalid transition");
+template <typename T, typename F>
+ObjectValue unaryKernel(const ObjectValue &exp) {
+  return F{}(payload<T>(exp));
 }
-ObjectValue OperatorVisitor::operator()(bool lhs, const std::string &rhs,
-                                        const std::string &op) const {
-  if ((op == "<-") && (rhs == "INT"))
-    return lhs ? types::Integer(1) : types::Integer(0);
-  if ((op == "<-") && (rhs == "STR"))
-    return lhs ? "true" : "false";
-  if ((op == "<-") && (rhs == "FLT"))
-    return lhs ? types::Float(1) : types::Float(0);
-  if ((op == "<-") && (rhs == "BOL"))
-    return lhs;
-  else
-    throw std::runtime_error("Invalid transition");
+
+// NOTE: a BigInt which fits in 64 bits is given back as Integer, so that
+// ints stay on the kernels of Integer whenever they can
+ObjectValue normalized(const types::BigInt &value) {
+  if (auto integer = value.toInteger())
+    return types::Integer(*integer);
+  return value;
 }
-ObjectValue OperatorVisitor::operator()(const Function &lhs,
-                                        const Function &rhs,
-                                        const std::string &op) const {
-  if (op == "|") {
-    auto res = lhs;
-    if (rhs.args.size() != 1) {
-      throw std::runtime_error("Rhs function wrong number of parameters.");
-    }
-    res.args2.push_back(rhs.args.at(0));
-    for (const auto &arg2 : rhs.args2)
-      res.args2.push_back(arg2);
-
-    for (const auto &rhs_body : rhs.body)
-      res.body.push_back(rhs_body->clone());
-    assert(res.body.size() - 1 == res.args2.size());
-    return res;
-  } else
-    throw std::runtime_error("Invalid transition");
+
+types::BigInt widened(const types::Integer &value) {
+  return types::BigInt(value.getValue());
 }
 
-// prefix operators
-ObjectValue OperatorVisitor::operator()(const types::Integer &exp,
-                                        const std::string &op) const {
-  if (op == "-")
-    return -exp;
-  else
-    return types::Integer(0);
+const types::BigInt &widened(const types::BigInt &value) { return value; }
+
+// NOTE: the policy is read only once a result overflowed, `promoted` gives
+// the result computed on BigInt
+template <typename F>
+ObjectValue overflowed(const types::Integer &wrapped, F promoted) {
+  switch (types::overflowPolicy()) {
+  case types::OverflowPolicy::WRAP:
+    return wrapped;
+  case types::OverflowPolicy::PROMOTE:
+    return promoted();
+  case types::OverflowPolicy::TRAP:
+    break;
+  }
+  throw std::runtime_error("Integer overflow.");
 }
 
-ObjectValue OperatorVisitor::operator()(const types::Float &exp,
-                                        const std::string &op) const {
-  if (op == "-")
-    return -exp;
-  else
-    return types::Integer(0);
+// integer arithmetic checked by `Overflows`, `Promoted` is the operator on
+// BigInt
+template <bool (types::Integer::*Overflows)(const types::Integer &,
+                                            types::Integer &) const,
+          typename Promoted>
+struct Checked {
+  ObjectValue operator()(const types::Integer &lhs,
+                         const types::Integer &rhs) const {
+    types::Integer result;
+    if (!(lhs.*Overflows)(rhs, result)) [[likely]]
+      return result;
+    return overflowed(result, [&]() -> ObjectValue {
+      return Promoted{}(widened(lhs), widened(rhs));
+    });
+  }
+};
+
+// operator `F` on BigInt, for ints of which at least one is out of 64 bits
+template <typename F> struct Wide {
+  template <typename L, typename R>
+  ObjectValue operator()(const L &lhs, const R &rhs) const {
+    auto result = F{}(widened(lhs), widened(rhs));
+    if constexpr (std::is_same_v<decltype(result), bool>)
+      return result;
+    else
+      return normalized(result);
+  }
+};
+
+struct BinaryTable {
+  Binary kernels[TYPES][TYPES][OPERATORS];
+
+  template <typename L, typename R, typename F>
+  void set(OperatorType op, F) {
+    kernels[typeIndex<L>()][typeIndex<R>()][static_cast<size_t>(op)] =
+        binaryKernel<L, R, F>;
+  }
+
+  // arithmetic and comparison, common for numeric types
+  template <typename T> void numeric() {
+    set<T, T>(OperatorType::PLUS, std::plus<>{});
+    set<T, T>(OperatorType::MINUS, std::minus<>{});
+    set<T, T>(OperatorType::STAR, std::multiplies<>{});
+    set<T, T>(OperatorType::SLASH, std::divides<>{});
+    set<T, T>(OperatorType::EQUALS, std::equal_to<>{});
+    set<T, T>(OperatorType::NEQ, std::not_equal_to<>{});
+    set<T, T>(OperatorType::LESS, std::less<>{});
+    set<T, T>(OperatorType::GREATER, std::greater<>{});
+    set<T, T>(OperatorType::LEQ, std::less_equal<>{});
+    set<T, T>(OperatorType::GEQ, std::greater_equal<>{});
+  }
+
+  // arithmetic and comparison of ints of which one is out of 64 bits
+  template <typename L, typename R> void wide() {
+    set<L, R>(OperatorType::PLUS, Wide<std::plus<>>{});
+    set<L, R>(OperatorType::MINUS, Wide<std::minus<>>{});
+    set<L, R>(OperatorType::STAR, Wide<std::multiplies<>>{});
+    set<L, R>(OperatorType::SLASH, Wide<std::divides<>>{});
+    set<L, R>(OperatorType::PERCENT, Wide<std::modulus<>>{});
+    set<L, R>(OperatorType::EQUALS, Wide<std::equal_to<>>{});
+    set<L, R>(OperatorType::NEQ, Wide<std::not_equal_to<>>{});
+    set<L, R>(OperatorType::LESS, Wide<std::less<>>{});
+    set<L, R>(OperatorType::GREATER, Wide<std::greater<>>{});
+    set<L, R>(OperatorType::LEQ, Wide<std::less_equal<>>{});
+    set<L, R>(OperatorType::GEQ, Wide<std::greater_equal<>>{});
+  }
+
+  BinaryTable() {
+    for (auto &lhs : kernels)
+      for (auto &rhs : lhs)
+        for (auto &kernel : rhs)
+          kernel = invalidBinary;
+
+    using types::Integer;
+    // NOTE: integer arithmetic is checked, the kernels of numeric() for it
+    // are replaced
+    numeric<Integer>();
+    set<Integer, Integer>(OperatorType::PLUS,
+                          Checked<&Integer::addOverflow, std::plus<>>{});
+    set<Integer, Integer>(OperatorType::MINUS,
+                          Checked<&Integer::subOverflow, std::minus<>>{});
+    set<Integer, Integer>(OperatorType::STAR,
+                          Checked<&Integer::mulOverflow, std::multiplies<>>{});
+    set<Integer, Integer>(OperatorType::SLASH,
+                          Checked<&Integer::divOverflow, std::divides<>>{});
+    set<Integer, Integer>(OperatorType::PERCENT, std::modulus<>{});
+    wide<types::BigInt, types::BigInt>();
+    wide<types::BigInt, Integer>();
+    wide<Integer, types::BigInt>();
+    numeric<types::Float>();
+
+    set<bool, bool>(OperatorType::AND, std::logical_and<>{});
+    set<bool, bool>(OperatorType::OR, std::logical_or<>{});
+
+    set<types::String, types::String>(
+        OperatorType::PLUS,
+        [](const types::String &lhs, const types::String &rhs) -> ObjectValue {
+          return types::String::concat(lhs, rhs);
+        });
+
+    set<Function, Function>(
+        OperatorType::PIPE,
+        [](const Function &lhs, const Function &rhs) -> ObjectValue {
+          if (rhs.args.size() != 1) {
+            throw std::runtime_error(
+                "Rhs function wrong number of parameters.");
+          }
+          return lhs.compose(rhs);
+        });
+  }
+};
+
+struct UnaryTable {
+  Unary kernels[TYPES][OPERATORS];
+
+  template <typename T, typename F> void set(OperatorType op, F) {
+    kernels[typeIndex<T>()][static_cast<size_t>(op)] = unaryKernel<T, F>;
+  }
+
+  UnaryTable() {
+    for (auto &type : kernels)
+      for (auto &kernel : type)
+        kernel = invalidUnary;
+
+    // NOTE: an operator not matching a numeric or bool operand gives 0
+    auto zero = [](const auto &) -> ObjectValue { return types::Integer(0); };
+    set<types::Integer>(
+        OperatorType::MINUS, [](const types::Integer &exp) -> ObjectValue {
+          types::Integer result;
+          if (!exp.negOverflow(result)) [[likely]]
+            return result;
+          return overflowed(result, [&]() -> ObjectValue {
+            return -widened(exp);
+          });
+        });
+    set<types::Integer>(OperatorType::BANG, zero);
+    set<types::BigInt>(OperatorType::MINUS,
+                       [](const types::BigInt &exp) -> ObjectValue {
+                         return normalized(-exp);
+                       });
+    set<types::BigInt>(OperatorType::BANG, zero);
+    set<types::Float>(OperatorType::MINUS,
+                      [](const types::Float &exp) -> ObjectValue {
+                        return -exp;
+                      });
+    set<types::Float>(OperatorType::BANG, zero);
+    set<bool>(OperatorType::BANG, [](bool exp) -> ObjectValue { return !exp; });
+    set<bool>(OperatorType::MINUS, zero);
+  }
+};
+
+struct CastTable {
+  Unary kernels[TYPES][CASTS];
+
+  template <typename T, typename F> void set(CastType type, F) {
+    kernels[typeIndex<T>()][static_cast<size_t>(type)] = unaryKernel<T, F>;
+  }
+
+  // casts to the own type return the operand
+  template <typename T> void keep(CastType type) {
+    kernels[typeIndex<T>()][static_cast<size_t>(type)] = identity;
+  }
+
+  CastTable() {
+    for (auto &type : kernels)
+      for (auto &kernel : type)
+        kernel = invalidUnary;
+
+    keep<types::Integer>(CastType::INT);
+    set<types::Integer>(CastType::STR,
+                        [](const types::Integer &exp) -> ObjectValue {
+                          return std::to_string(exp.getValue());
+                        });
+    set<types::Integer>(CastType::FLT,
+                        [](const types::Integer &exp) -> ObjectValue {
+                          return types::Float(
+                              static_cast<double>(exp.getValue()));
+                        });
+    set<types::Integer>(CastType::BOL,
+                        [](const types::Integer &exp) -> ObjectValue {
+                          return exp.getValue() != 0;
+                        });
+
+    keep<types::BigInt>(CastType::INT);
+    set<types::BigInt>(CastType::STR,
+                       [](const types::BigInt &exp) -> ObjectValue {
+                         return exp.str();
+                       });
+    set<types::BigInt>(CastType::FLT,
+                       [](const types::BigInt &exp) -> ObjectValue {
+                         return types::Float(exp.toDouble());
+                       });
+    // NOTE: zero is never out of 64 bits
+    set<types::BigInt>(CastType::BOL,
+                       [](const types::BigInt &) -> ObjectValue {
+                         return true;
+                       });
+
+    set<types::Float>(CastType::INT,
+                      [](const types::Float &exp) -> ObjectValue {
+                        double value = exp.getValue();
+                        if (!std::isfinite(value))
+                          throw std::runtime_error(
+                              "Float out of integer range.");
+                        return normalized(types::BigInt::fromDouble(value));
+                      });
+    set<types::Float>(CastType::STR,
+                      [](const types::Float &exp) -> ObjectValue {
+                        return std::to_string(exp.getValue());
+                      });
+    keep<types::Float>(CastType::FLT);
+
+    set<bool>(CastType::INT, [](bool exp) -> ObjectValue {
+      return exp ? types::Integer(1) : types::Integer(0);
+    });
+    set<bool>(CastType::STR, [](bool exp) -> ObjectValue {
+      return exp ? "true" : "false";
+    });
+    set<bool>(CastType::FLT, [](bool exp) -> ObjectValue {
+      return exp ? types::Float(1) : types::Float(0);
+    });
+    keep<bool>(CastType::BOL);
+
+    keep<types::String>(CastType::STR);
+  }
+};
+
+const BinaryTable binaryTable;
+const UnaryTable unaryTable;
+const CastTable castTable;
+
+CacheStats stats;
+
+} // namespace
+
+ObjectValue binaryOperator(const ObjectValue &lhs, const ObjectValue &rhs,
+                           types::OperatorType op) {
+  const ObjectValue &left = dereference(lhs);
+  const ObjectValue &right = dereference(rhs);
+  return binaryTable.kernels[static_cast<size_t>(left.type())]
+                            [static_cast<size_t>(right.type())]
+                            [static_cast<size_t>(op)](left, right);
 }
 
-ObjectValue OperatorVisitor::operator()(bool exp, const std::string &op) const {
-  if (op == "!")
-    return !exp;
-  else
-    return types::Integer(0);
+ObjectValue binaryOperator(const ObjectValue &lhs, const ObjectValue &rhs,
+                           types::OperatorType op, InlineCache &cache) {
+  const ObjectValue &left = dereference(lhs);
+  const ObjectValue &right = dereference(rhs);
+  auto leftType = static_cast<uint8_t>(left.type());
+  auto rightType = static_cast<uint8_t>(right.type());
+  for (const auto &entry : cache.entries) {
+    if (entry.left == leftType && entry.right == rightType) {
+      ++stats.hits;
+      return entry.kernel(left, right);
+    }
+  }
+  ++stats.misses;
+  Binary kernel =
+      binaryTable.kernels[leftType][rightType][static_cast<size_t>(op)];
+  // the oldest entry is dropped
+  for (size_t i = InlineCache::ENTRIES - 1; i > 0; --i)
+    cache.entries[i] = cache.entries[i - 1];
+  cache.entries[0] = {leftType, rightType, kernel};
+  return kernel(left, right);
 }
 
-// NOTE: Just handling references
-ObjectValue
-OperatorVisitor::operator()(const std::reference_wrapper<Object> &lhs,
-                            const std::reference_wrapper<Object> &rhs,
-                            const std::string &op) const {
-  return std::visit(*this, lhs.get().value, rhs.get().value,
-                    std::variant<std::string>(op));
+ObjectValue prefixOperator(const ObjectValue &exp, types::OperatorType op) {
+  const ObjectValue &value = dereference(exp);
+  return unaryTable.kernels[static_cast<size_t>(value.type())]
+                           [static_cast<size_t>(op)](value);
 }
 
+ObjectValue castOperator(const ObjectValue &exp, types::CastType type) {
+  const ObjectValue &value = dereference(exp);
+  return castTable.kernels[static_cast<size_t>(value.type())]
+                          [static_cast<size_t>(type)](value);
+}
+
+CacheStats &cacheStats() { return stats; }
+
 } // namespace pheonix::eval
@@ -0,0 +1,239 @@
+#include "optimizer.hpp"
+#include "object.hpp"
+#include "operator_visitor.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+namespace pheonix::optimizer {
+
+namespace {
+
+node::Literal *literal(const std::unique_ptr<node::Node> &node) {
+  return dynamic_cast<node::Literal *>(node.get());
+}
+
+// NOTE: functions and references have no literal
+std::optional<Primitive> primitive(const eval::ObjectValue &value) {
+  switch (value.type()) {
+  case eval::ObjectValue::Type::NIL:
+    return Primitive(std::monostate());
+  case eval::ObjectValue::Type::INT:
+    return Primitive(value.asInteger());
+  case eval::ObjectValue::Type::FLT:
+    return Primitive(value.asFloat());
+  case eval::ObjectValue::Type::STR:
+    return Primitive(value.asString());
+  case eval::ObjectValue::Type::BOL:
+    return Primitive(value.asBool());
+  default:
+    return std::nullopt;
+  }
+}
+
+// literal with the value computed by `fold`, nullptr if it fails
+template <typename F> std::unique_ptr<node::Node> folded(F fold) {
+  try {
+    if (auto value = primitive(fold()))
+      return std::make_unique<node::Literal>(*value);
+  } catch (const std::exception &) {
+  }
+  return nullptr;
+}
+
+// type every value of the expression has, if it is known
+std::optional<types::CastType>
+typeOf(const std::unique_ptr<node::Node> &node) {
+  if (auto *cast = dynamic_cast<node::CastExpression *>(node.get()))
+    if (auto *type = dynamic_cast<node::TypeSpecifier *>(cast->type.get()))
+      return type->type;
+  return std::nullopt;
+}
+
+} // namespace
+
+Optimizer::Optimizer() : visitor::Visitor(), replacement(), replaced(0) {}
+
+void Optimizer::optimize(node::Node &root) {
+  replaced = 0;
+  root.accept(*this);
+  replacement.reset();
+}
+
+void Optimizer::optimize(std::unique_ptr<node::Node> &node) {
+  if (!node)
+    return;
+  node->accept(*this);
+  if (replacement) {
+    // a folded literal takes the place of the folded expression
+    if (replacement->id == node::Spans::NONE)
+      replacement->id = node->id;
+    node = std::move(replacement);
+    ++replaced;
+  }
+}
+
+void Optimizer::statements(
+    std::vector<std::unique_ptr<node::Node>> &statements) {
+  std::vector<std::unique_ptr<node::Node>> kept;
+  for (size_t i = 0; i < statements.size(); ++i) {
+    optimize(statements[i]);
+    // NOTE: every other statement sets the result, so only the last null
+    // statement of a body can be seen
+    if (i + 1 < statements.size() &&
+        dynamic_cast<node::NullStatement *>(statements[i].get())) {
+      ++replaced;
+      continue;
+    }
+    kept.push_back(std::move(statements[i]));
+  }
+  statements = std::move(kept);
+}
+
+template <typename Binary> void Optimizer::binary(Binary &expression) {
+  optimize(expression.left);
+  optimize(expression.right);
+  auto *left = literal(expression.left);
+  auto *right = literal(expression.right);
+  if (!left || !right)
+    return;
+  replacement = folded([&] {
+    return eval::binaryOperator(eval::castVariants(left->value),
+                                eval::castVariants(right->value),
+                                expression.op);
+  });
+}
+
+// NOTE: the right side is not evaluated when the left one decides
+template <typename Logical>
+void Optimizer::logical(Logical &expression, bool decisive) {
+  binary(expression);
+  auto *left = literal(expression.left);
+  if (!replacement && left && std::holds_alternative<bool>(left->value) &&
+      std::get<bool>(left->value) == decisive)
+    replacement = std::make_unique<node::Literal>(Primitive(decisive));
+}
+
+void Optimizer::visit(node::Program &p) {
+  // NOTE: new nodes are placed with the parsed ones
+  std::optional<arena::Arena::Scope> scope;
+  if (p.arena)
+    scope.emplace(*p.arena);
+  statements(p.statements);
+}
+
+void Optimizer::visit(node::Parameter &) {}
+
+void Optimizer::visit(node::DeclarationArguments &) {}
+
+void Optimizer::visit(node::Block &b) { statements(b.statements); }
+
+// NOTE: a body is a block, which is never replaced
+void Optimizer::visit(node::FunctionDeclaration &fd) {
+  fd.statements->accept(*this);
+}
+
+void Optimizer::visit(node::VariableDeclaration &vd) {
+  optimize(vd.expression);
+}
+
+void Optimizer::visit(node::WhileLoopStatement &wls) {
+  optimize(wls.expression);
+  optimize(wls.statements);
+}
+
+void Optimizer::visit(node::IfStatement &is) {
+  optimize(is.predicate);
+  optimize(is.ifBody);
+  optimize(is.elseBody);
+}
+
+void Optimizer::visit(node::ReturnStatement &rs) { optimize(rs.expression); }
+
+void Optimizer::visit(node::ExpressionStatement &es) {
+  optimize(es.expression);
+}
+
+void Optimizer::visit(node::NullStatement &) {}
+
+void Optimizer::visit(node::AssignementExpression &ae) {
+  optimize(ae.expression);
+}
+
+void Optimizer::visit(node::OrExpression &oe) { logical(oe, true); }
+
+void Optimizer::visit(node::AndExpression &ae) { logical(ae, false); }
+
+void Optimizer::visit(node::ComparisonExpression &ce) { binary(ce); }
+
+void Optimizer::visit(node::RelationalExpression &re) { binary(re); }
+
+void Optimizer::visit(node::MultiplicativeExpression &me) { binary(me); }
+
+// NOTE: operands of a composition are functions, nothing to fold
+void Optimizer::visit(node::CompositiveExpression &ce) {
+  optimize(ce.left);
+  optimize(ce.right);
+}
+
+void Optimizer::visit(node::AdditiveExpression &ae) { binary(ae); }
+
+void Optimizer::visit(node::CastExpression &ce) {
+  optimize(ce.expression);
+  auto *type = dynamic_cast<node::TypeSpecifier *>(ce.type.get());
+  if (!type)
+    return;
+  // casts return a value of the target type, casting it again keeps it
+  if (typeOf(ce.expression) == type->type) {
+    replacement = std::move(ce.expression);
+    return;
+  }
+  if (auto *value = literal(ce.expression))
+    replacement = folded([&] {
+      return eval::castOperator(eval::castVariants(value->value), type->type);
+    });
+}
+
+void Optimizer::visit(node::PrefixExpression &pe) {
+  optimize(pe.expression);
+  if (auto *value = literal(pe.expression))
+    replacement = folded([&] {
+      return eval::prefixOperator(eval::castVariants(value->value), pe.op);
+    });
+}
+
+void Optimizer::visit(node::CallExpression &ce) {
+  optimize(ce.function);
+  optimize(ce.arguments);
+}
+
+void Optimizer::visit(node::DebugExpression &de) {
+  optimize(de.function);
+  optimize(de.arguments);
+}
+
+void Optimizer::visit(node::CallArguments &ca) {
+  for (auto &argument : ca.arguments)
+    optimize(argument);
+}
+
+void Optimizer::visit(node::LambdaExpression &le) {
+  le.statements->accept(*this);
+}
+
+void Optimizer::visit(node::Identifier &) {}
+
+// NOTE: an identifier in parentheses is still passed by reference, so
+// dropping them changes nothing
+void Optimizer::visit(node::ParentExpression &pe) {
+  optimize(pe.expression);
+  replacement = std::move(pe.expression);
+}
+
+void Optimizer::visit(node::Literal &) {}
+
+void Optimizer::visit(node::TypeSpecifier &) {}
+
+void Optimizer::visit(node::PrintFunction &) {}
+
+} // namespace pheonix::optimizer
@@ -8,11 +8,34 @@
 #include <string>
 
 namespace pheonix::parser {
+
+node::Position Parser::position() const {
+  return {static_cast<uint32_t>(current.line),
+          static_cast<uint32_t>(current.column)};
+}
+
+template <typename N>
+std::unique_ptr<N> Parser::spanned(std::unique_ptr<N> node,
+                                   node::Position from) {
+  node->id = spans->add(node::Span{from, lastEnd});
+  return node;
+}
+
 /*
  * PROGRAM = { STATEMENT } ;
  */
-std::unique_ptr<node::Node> Parser::parseProgram() {
+std::unique_ptr<node::Program> Parser::newProgram() {
+  // the program itself lives on the heap, as it is the owner of the arena
   auto program = std::make_unique<node::Program>();
+  program->arena = arena = std::make_shared<arena::Arena>();
+  spans = std::make_shared<node::Spans>();
+  program->spans = spans;
+  return program;
+}
+
+std::unique_ptr<node::Node> Parser::parseProgram() {
+  auto program = newProgram();
+  arena::Arena::Scope scope(*program->arena);
   while (auto statement = parseStatement()) {
     program->statements.push_back(std::move(statement));
   }
@@ -24,12 +47,13 @@ std::unique_ptr<node::Node> Parser::parseProgram() {
  * "{" { STATEMENT } "}"
  */
 std::unique_ptr<node::Node> Parser::parseBlock() {
+  auto from = position();
   auto block = std::make_unique<node::Block>();
   consumeIf(token::TokenType::LBRACE);
   while (auto statement = parseStatement())
     block->statements.push_back(std::move(statement));
   consumeIf(token::TokenType::RBRACE);
-  return block;
+  return spanned(std::move(block), from);
 }
 
 /*
@@ -69,12 +93,14 @@ std::unique_ptr<node::Node> Parser::parseStatement() {
 std::unique_ptr<node::Node> Parser::parseNullStatement() {
   if (current != token::TokenType::SEMICOLON)
     return nullptr;
+  auto from = position();
   readLex();
-  return std::make_unique<node::NullStatement>();
+  return spanned(std::make_unique<node::NullStatement>(), from);
 }
 
 std::unique_ptr<node::Node> Parser::parseParameter() {
-  bool isMutable;
+  auto from = position();
+  bool isMutable = false;
   if (current == token::TokenType::MUT) {
     isMutable = true;
     readLex();
@@ -85,10 +111,11 @@ std::unique_ptr<node::Node> Parser::parseParameter() {
                                        current.column);
     return nullptr;
   }
-  std::string paramIdentifier = std::get<std::string>(current.token.getValue());
+  symbol::Symbol paramIdentifier = current.token.getSymbol();
   readLex();
 
-  return std::make_unique<node::Parameter>(isMutable, paramIdentifier);
+  return spanned(std::make_unique<node::Parameter>(isMutable, paramIdentifier),
+                 from);
 }
 
 /*
@@ -99,13 +126,14 @@ std::unique_ptr<node::Node> Parser::parseParameter() {
  *                           ] ;
  */
 std::unique_ptr<node::Node> Parser::parseDeclarationArguments() {
+  auto from = position();
   consumeIf(token::TokenType::LPARENT);
   auto args = std::make_unique<node::DeclarationArguments>();
   if (auto param = parseParameter()) {
     args->arguments.push_back(std::move(param));
   } else {
     consumeIf(token::TokenType::RPARENT);
-    return args;
+    return spanned(std::move(args), from);
   }
 
   while (current == token::TokenType::COMMA) {
@@ -117,7 +145,7 @@ std::unique_ptr<node::Node> Parser::parseDeclarationArguments() {
     args->arguments.push_back(std::move(param));
   }
   consumeIf(token::TokenType::RPARENT);
-  return args;
+  return spanned(std::move(args), from);
 }
 
 /*
@@ -127,9 +155,10 @@ std::unique_ptr<node::Node> Parser::parseDeclarationArguments() {
 std::unique_ptr<node::Node> Parser::parseFunctionDeclaration() {
   if (current != token::TokenType::FN)
     return nullptr;
+  auto from = position();
   readLex();
   expect(token::TokenType::IDENTIFIER);
-  std::string identifier = std::get<std::string>(current.token.getValue());
+  symbol::Symbol identifier = current.token.getSymbol();
   auto functionDeclaration =
       std::make_unique<node::FunctionDeclaration>(identifier);
   readLex();
@@ -138,8 +167,8 @@ std::unique_ptr<node::Node> Parser::parseFunctionDeclaration() {
   functionDeclaration->arguments = std::move(declarationArguments);
   expect(token::TokenType::LBRACE);
   auto block = parseBlock();
-  functionDeclaration->statements = std::move(block);
-  return functionDeclaration;
+  functionDeclaration->statements = shared(std::move(block));
+  return spanned(std::move(functionDeclaration), from);
 }
 
 /*
@@ -148,6 +177,7 @@ std::unique_ptr<node::Node> Parser::parseFunctionDeclaration() {
 std::unique_ptr<node::Node> Parser::parseVariableDeclaration() {
   if (current != token::TokenType::LET)
     return nullptr;
+  auto from = position();
   readLex();
   bool isMutable = false;
   if (current == token::TokenType::MUT) {
@@ -155,13 +185,14 @@ std::unique_ptr<node::Node> Parser::parseVariableDeclaration() {
     readLex();
   }
   expect(token::TokenType::IDENTIFIER);
-  std::string identifier = std::get<std::string>(current.token.getValue());
+  symbol::Symbol identifier = current.token.getSymbol();
   readLex();
   consumeIf(token::TokenType::ASSIGN);
   if (auto expression = parseExpression()) {
     consumeIf(token::TokenType::SEMICOLON);
-    return std::make_unique<node::VariableDeclaration>(isMutable, identifier,
-                                                       std::move(expression));
+    return spanned(std::make_unique<node::VariableDeclaration>(
+                       isMutable, identifier, std::move(expression)),
+                   from);
   }
   throw exception::ParserException(
       "Failed parsing expression in variable declaration.", current.line,
@@ -176,6 +207,7 @@ std::unique_ptr<node::Node> Parser::parseVariableDeclaration() {
 std::unique_ptr<node::Node> Parser::parseWhileLoopStatement() {
   if (current != token::TokenType::WHILE)
     return nullptr;
+  auto from = position();
   readLex();
   consumeIf(token::TokenType::LPARENT);
   if (current == token::TokenType::RPARENT)
@@ -186,8 +218,9 @@ std::unique_ptr<node::Node> Parser::parseWhileLoopStatement() {
   consumeIf(token::TokenType::RPARENT);
   auto block = parseBlock();
 
-  return std::make_unique<node::WhileLoopStatement>(std::move(expression),
-                                                    std::move(block));
+  return spanned(std::make_unique<node::WhileLoopStatement>(
+                     std::move(expression), std::move(block)),
+                 from);
 }
 
 /*
@@ -204,6 +237,7 @@ std::unique_ptr<node::Node> Parser::parseWhileLoopStatement() {
 std::unique_ptr<node::Node> Parser::parseIfStatement() {
   if (current != token::TokenType::IF)
     return nullptr;
+  auto from = position();
   readLex();
   consumeIf(token::TokenType::LPARENT);
   if (current == token::TokenType::RPARENT)
@@ -221,7 +255,7 @@ std::unique_ptr<node::Node> Parser::parseIfStatement() {
   ifStmt->ifBody = std::move(ifBody);
   auto elseBody = parseElse();
   ifStmt->elseBody = std::move(elseBody);
-  return ifStmt;
+  return spanned(std::move(ifStmt), from);
 }
 
 std::unique_ptr<node::Node> Parser::parseElse() {
@@ -240,14 +274,16 @@ std::unique_ptr<node::Node> Parser::parseElse() {
 std::unique_ptr<node::Node> Parser::parseReturnStatement() {
   if (current != token::TokenType::RETURN)
     return nullptr;
+  auto from = position();
   readLex();
   if (current == token::TokenType::SEMICOLON) {
     readLex();
-    return std::make_unique<node::ReturnStatement>(nullptr);
+    return spanned(std::make_unique<node::ReturnStatement>(nullptr), from);
   }
   if (auto expression = parseExpression()) {
     consumeIf(token::TokenType::SEMICOLON);
-    return std::make_unique<node::ReturnStatement>(std::move(expression));
+    return spanned(
+        std::make_unique<node::ReturnStatement>(std::move(expression)), from);
   }
   throw exception::ParserException("Expected expression.", current.line,
                                    current.column);
@@ -257,9 +293,12 @@ std::unique_ptr<node::Node> Parser::parseReturnStatement() {
  * EXPRESSION_STATEMENT = EXPRESSION ";" ;
  */
 std::unique_ptr<node::Node> Parser::parseExpressionStatement() {
+  auto from = position();
   if (auto expression = parseExpression()) {
     consumeIf(token::TokenType::SEMICOLON);
-    return std::make_unique<node::ExpressionStatement>(std::move(expression));
+    return spanned(
+        std::make_unique<node::ExpressionStatement>(std::move(expression)),
+        from);
   }
   return nullptr;
 }
@@ -280,13 +319,15 @@ std::unique_ptr<node::Node> Parser::parseExpression() {
 std::unique_ptr<node::Node> Parser::parseAssignementExpression() {
   if (next != token::TokenType::ASSIGN)
     return nullptr;
+  auto from = position();
   expect(token::TokenType::IDENTIFIER);
-  std::string identifier = std::get<std::string>(current.token.getValue());
+  symbol::Symbol identifier = current.token.getSymbol();
   readLex();
   consumeIf(token::TokenType::ASSIGN);
   if (auto expression = parseOrExpression()) {
-    return std::make_unique<node::AssignementExpression>(identifier,
-                                                         std::move(expression));
+    return spanned(std::make_unique<node::AssignementExpression>(
+                       identifier, std::move(expression)),
+                   from);
   }
   throw exception::ParserException("Expected expression.", current.line,
                                    current.column);
@@ -297,12 +338,15 @@ std::unique_ptr<node::Node> Parser::parseAssignementExpression() {
  *    { "||" AND_EXPRESSION } ;
  */
 std::unique_ptr<node::Node> Parser::parseOrExpression() {
+  auto from = position();
   if (auto left = parseAndExpression()) {
     while (current == token::TokenType::OR) {
       readLex();
       auto right = parseAndExpression();
-      left = std::make_unique<node::OrExpression>(std::move(left),
-                                                  std::move(right), "||");
+      left = spanned(std::make_unique<node::OrExpression>(
+                         std::move(left), std::move(right),
+                         types::OperatorType::OR),
+                     from);
     }
     return left;
   }
@@ -314,12 +358,15 @@ std::unique_ptr<node::Node> Parser::parseOrExpression() {
  *                  { "&&" COMPARISON_EXPRESSION } ;
  */
 std::unique_ptr<node::Node> Parser::parseAndExpression() {
+  auto from = position();
   if (auto left = parseComparisonExpression()) {
     while (current == token::TokenType::AND) {
       readLex();
       auto right = parseComparisonExpression();
-      left = std::make_unique<node::AndExpression>(std::move(left),
-                                                   std::move(right), "&&");
+      left = spanned(std::make_unique<node::AndExpression>(
+                         std::move(left), std::move(right),
+                         types::OperatorType::AND),
+                     from);
     }
     return left;
   }
@@ -332,14 +379,17 @@ std::unique_ptr<node::Node> Parser::parseAndExpression() {
  *                         RELATIONAL_EXPRESSION ] ;
  */
 std::unique_ptr<node::Node> Parser::parseComparisonExpression() {
+  auto from = position();
   if (auto left = parseRelationalExpression()) {
     if (current == token::TokenType::EQUALS ||
         current == token::TokenType::NEQ) {
       token::TokenType op = current.token.getTokenType();
       readLex();
       auto right = parseRelationalExpression();
-      left = std::make_unique<node::ComparisonExpression>(
-          std::move(left), std::move(right), types::opToString(op));
+      left = spanned(std::make_unique<node::ComparisonExpression>(
+                         std::move(left), std::move(right),
+                         types::tokenTypeToOperator(op)),
+                     from);
     }
     return left;
   }
@@ -352,6 +402,7 @@ std::unique_ptr<node::Node> Parser::parseComparisonExpression() {
  *                         ADDITIVE_EXPRESSION ] ;
  */
 std::unique_ptr<node::Node> Parser::parseRelationalExpression() {
+  auto from = position();
   if (auto left = parseAdditiveExpression()) {
     if (current == token::TokenType::LESS ||
         current == token::TokenType::GREATER ||
@@ -359,8 +410,10 @@ std::unique_ptr<node::Node> Parser::parseRelationalExpression() {
       token::TokenType op = current.token.getTokenType();
       readLex();
       auto right = parseAdditiveExpression();
-      left = std::make_unique<node::RelationalExpression>(
-          std::move(left), std::move(right), types::opToString(op));
+      left = spanned(std::make_unique<node::RelationalExpression>(
+                         std::move(left), std::move(right),
+                         types::tokenTypeToOperator(op)),
+                     from);
     }
     return left;
   }
@@ -373,14 +426,17 @@ std::unique_ptr<node::Node> Parser::parseRelationalExpression() {
  *                       MULTIPLICATIVE_EXPRESSION } ;
  */
 std::unique_ptr<node::Node> Parser::parseAdditiveExpression() {
+  auto from = position();
   if (auto left = parseMultiplicativeExpression()) {
     while (current == token::TokenType::PLUS ||
            current == token::TokenType::MINUS) {
       token::TokenType op = current.token.getTokenType();
       readLex();
       auto right = parseMultiplicativeExpression();
-      left = std::make_unique<node::AdditiveExpression>(
-          std::move(left), std::move(right), types::opToString(op));
+      left = spanned(std::make_unique<node::AdditiveExpression>(
+                         std::move(left), std::move(right),
+                         types::tokenTypeToOperator(op)),
+                     from);
     }
     return left;
   }
@@ -393,6 +449,7 @@ std::unique_ptr<node::Node> Parser::parseAdditiveExpression() {
  *                             COMPOSITIVE_EXPRESSION } ;
  */
 std::unique_ptr<node::Node> Parser::parseMultiplicativeExpression() {
+  auto from = position();
   if (std::unique_ptr<node::Node> left = parseCompositiveExpression()) {
     while (current == token::TokenType::STAR ||
            current == token::TokenType::SLASH ||
@@ -400,8 +457,10 @@ std::unique_ptr<node::Node> Parser::parseMultiplicativeExpression() {
       token::TokenType op = current.token.getTokenType();
       readLex();
       std::unique_ptr<node::Node> right = parseCompositiveExpression();
-      left = std::make_unique<node::MultiplicativeExpression>(
-          std::move(left), std::move(right), types::opToString(op));
+      left = spanned(std::make_unique<node::MultiplicativeExpression>(
+                         std::move(left), std::move(right),
+                         types::tokenTypeToOperator(op)),
+                     from);
     }
     return left;
   }
@@ -413,12 +472,14 @@ std::unique_ptr<node::Node> Parser::parseMultiplicativeExpression() {
  *                          { "|" CAST_EXPRESSION } ;
  */
 std::unique_ptr<node::Node> Parser::parseCompositiveExpression() {
+  auto from = position();
   if (std::unique_ptr<node::Node> left = parseCastExpression()) {
     while (current == token::TokenType::PIPE) {
       readLex();
       std::unique_ptr<node::Node> right = parseCastExpression();
-      left = std::make_unique<node::CompositiveExpression>(std::move(left),
-                                                           std::move(right));
+      left = spanned(std::make_unique<node::CompositiveExpression>(
+                         std::move(left), std::move(right)),
+                     from);
     }
     return left;
   }
@@ -429,12 +490,14 @@ std::unique_ptr<node::Node> Parser::parseCompositiveExpression() {
  * CAST_EXPRESSION = PREFIX_EXPRESSION { "<-" TYPE_NAME } ;
  */
 std::unique_ptr<node::Node> Parser::parseCastExpression() {
+  auto from = position();
   if (std::unique_ptr<node::Node> expression = parsePrefixExpression()) {
     while (current == token::TokenType::LARROW) {
       readLex();
       std::unique_ptr<node::Node> type = parseTypeSpecifier();
-      expression = std::make_unique<node::CastExpression>(std::move(expression),
-                                                          std::move(type));
+      expression = spanned(std::make_unique<node::CastExpression>(
+                               std::move(expression), std::move(type)),
+                           from);
     }
     return expression;
   }
@@ -449,11 +512,13 @@ std::unique_ptr<node::Node> Parser::parseCastExpression() {
 std::unique_ptr<node::Node> Parser::parsePrefixExpression() {
   std::unique_ptr<node::Node> expression;
   if (current == token::TokenType::BANG || current == token::TokenType::MINUS) {
+    auto from = position();
     token::TokenType op = current.token.getTokenType();
     readLex();
     auto node = parseOtherExpression();
-    return std::make_unique<node::PrefixExpression>(types::opToString(op),
-                                                    std::move(node));
+    return spanned(std::make_unique<node::PrefixExpression>(
+                       types::tokenTypeToOperator(op), std::move(node)),
+                   from);
   }
   return parseOtherExpression();
 }
@@ -494,11 +559,13 @@ std::unique_ptr<node::Node> Parser::parseMaybeCallExpression() {
  * MAYBE_IDENTIFIER_CALL = IDENTIFIER { "(" EXPRESSION_LIST ")" } ;
  */
 std::unique_ptr<node::Node> Parser::parseMaybeIdentifierCall() {
+  auto from = position();
   if (auto node = parseIdentifier()) {
     while (current == token::TokenType::LPARENT) {
       std::unique_ptr<node::Node> callArguments = parseCallArguments();
-      node = std::make_unique<node::CallExpression>(std::move(node),
-                                                    std::move(callArguments));
+      node = spanned(std::make_unique<node::CallExpression>(
+                         std::move(node), std::move(callArguments)),
+                     from);
     }
     return node;
   }
@@ -508,11 +575,13 @@ std::unique_ptr<node::Node> Parser::parseMaybeIdentifierCall() {
  * MAYBE_LAMBDA_CALL = LAMBDA_EXPRESSION { "(" EXPRESSION_LIST ")" } ;
  */
 std::unique_ptr<node::Node> Parser::parseMaybeLambdaCall() {
+  auto from = position();
   if (auto node = parseLambdaExpression()) {
     while (current == token::TokenType::LPARENT) {
       std::unique_ptr<node::Node> callArguments = parseCallArguments();
-      node = std::make_unique<node::CallExpression>(std::move(node),
-                                                    std::move(callArguments));
+      node = spanned(std::make_unique<node::CallExpression>(
+                         std::move(node), std::move(callArguments)),
+                     from);
     }
     return node;
   }
@@ -523,11 +592,13 @@ std::unique_ptr<node::Node> Parser::parseMaybeLambdaCall() {
  * MAYBE_PARENT_CALL = PARENT_EXPRESSION { "(" EXPRESSION_LIST ")" } ;
  */
 std::unique_ptr<node::Node> Parser::parseMaybeParentCall() {
+  auto from = position();
   if (auto node = parseParentExpression()) {
     while (current == token::TokenType::LPARENT) {
       std::unique_ptr<node::Node> callArguments = parseCallArguments();
-      node = std::make_unique<node::CallExpression>(std::move(node),
-                                                    std::move(callArguments));
+      node = spanned(std::make_unique<node::CallExpression>(
+                         std::move(node), std::move(callArguments)),
+                     from);
     }
     return node;
   }
@@ -537,11 +608,13 @@ std::unique_ptr<node::Node> Parser::parseMaybeParentCall() {
  * MAYBE_DEBUG_CALL = DEBUG_EXPRESSION { "(" EXPRESSION_LIST ")" } ;
  */
 std::unique_ptr<node::Node> Parser::parseMaybeDebugCall() {
+  auto from = position();
   if (auto node = parseDebugExpression()) {
     while (current == token::TokenType::LPARENT) {
       std::unique_ptr<node::Node> callArguments = parseCallArguments();
-      node = std::make_unique<node::CallExpression>(std::move(node),
-                                                    std::move(callArguments));
+      node = spanned(std::make_unique<node::CallExpression>(
+                         std::move(node), std::move(callArguments)),
+                     from);
     }
     return node;
   }
@@ -550,9 +623,10 @@ std::unique_ptr<node::Node> Parser::parseMaybeDebugCall() {
 
 std::unique_ptr<node::Node> Parser::parseIdentifier() {
   if (current == token::TokenType::IDENTIFIER) {
-    std::string val = std::get<std::string>(current.token.getValue());
+    auto from = position();
+    symbol::Symbol val = current.token.getSymbol();
     readLex();
-    return std::make_unique<node::Identifier>(val);
+    return spanned(std::make_unique<node::Identifier>(val), from);
   }
   return nullptr;
 }
@@ -561,13 +635,15 @@ std::unique_ptr<node::Node> Parser::parseIdentifier() {
  */
 std::unique_ptr<node::Node> Parser::parseLambdaExpression() {
   if (current == token::TokenType::HASH) {
+    auto from = position();
     readLex();
     expect(token::TokenType::LPARENT);
     auto arguments = parseDeclarationArguments();
     expect(token::TokenType::LBRACE);
     auto statements = parseBlock();
-    return std::make_unique<node::LambdaExpression>(std::move(arguments),
-                                                    std::move(statements));
+    return spanned(std::make_unique<node::LambdaExpression>(
+                       std::move(arguments), shared(std::move(statements))),
+                   from);
   }
   return nullptr;
 }
@@ -577,11 +653,12 @@ std::unique_ptr<node::Node> Parser::parseLambdaExpression() {
  */
 std::unique_ptr<node::Node> Parser::parseParentExpression() {
   if (current == token::TokenType::LPARENT) {
+    auto from = position();
     readLex();
     auto pExpression =
         std::make_unique<node::ParentExpression>(parseExpression());
     consumeIf(token::TokenType::RPARENT);
-    return pExpression;
+    return spanned(std::move(pExpression), from);
   }
   return nullptr;
 }
@@ -591,13 +668,15 @@ std::unique_ptr<node::Node> Parser::parseParentExpression() {
  */
 std::unique_ptr<node::Node> Parser::parseDebugExpression() {
   if (current == token::TokenType::LBRACKET) {
+    auto from = position();
     readLex();
     auto function = parseExpression();
     consumeIf(token::TokenType::RBRACKET);
     expect(token::TokenType::LPARENT);
     auto callArguments = parseCallArguments();
-    return std::make_unique<node::DebugExpression>(std::move(function),
-                                                   std::move(callArguments));
+    return spanned(std::make_unique<node::DebugExpression>(
+                       std::move(function), std::move(callArguments)),
+                   from);
   }
   return nullptr;
 }
@@ -606,6 +685,7 @@ std::unique_ptr<node::Node> Parser::parseDebugExpression() {
  * EXPRESSION_LIST = [ EXPRESSION { "," EXPRESSION } ] ;
  */
 std::unique_ptr<node::Node> Parser::parseCallArguments() {
+  auto from = position();
   auto arguments = std::make_unique<node::CallArguments>();
   consumeIf(token::TokenType::LPARENT);
   while (current != token::TokenType::RPARENT) {
@@ -615,7 +695,7 @@ std::unique_ptr<node::Node> Parser::parseCallArguments() {
     readLex();
   }
   consumeIf(token::TokenType::RPARENT);
-  return arguments;
+  return spanned(std::move(arguments), from);
 }
 
 /*
@@ -629,9 +709,10 @@ std::unique_ptr<node::Node> Parser::parseLiteral() {
       current == token::TokenType::STRING ||
       current == token::TokenType::FLOAT ||
       current == token::TokenType::FALSE || current == token::TokenType::TRUE) {
+    auto from = position();
     auto node = std::make_unique<node::Literal>(current.token.getValue());
     readLex();
-    return node;
+    return spanned(std::move(node), from);
   };
   return nullptr;
 }
@@ -643,8 +724,9 @@ std::unique_ptr<node::Node> Parser::parseTypeSpecifier() {
   std::string type = types::tokenTypeToLiteral(current.token.getTokenType());
 
   if (type == "FLT" || type == "INT" || type == "STR" || type == "BOL") {
+    auto from = position();
     readLex();
-    return std::make_unique<node::TypeSpecifier>(type);
+    return spanned(std::make_unique<node::TypeSpecifier>(type), from);
   }
   throw exception::ParserException("Expected type specifier.", current.line,
                                    current.column);
@@ -669,20 +751,44 @@ void Parser::consumeIf(token::TokenType token) {
       current.line, current.column);
 }
 
+std::shared_ptr<node::Node>
+Parser::shared(std::unique_ptr<node::Node> body) {
+  // NOTE: the deleter holds the arena, which is freed after the body
+  return {body.release(), [arena = arena](node::Node *node) { delete node; }};
+}
+
 std::unique_ptr<node::Node> Parser::generateParsingTree() {
-  std::optional<std::unique_ptr<node::Node>> maybeResult;
-  maybeResult = parse();
-  if (maybeResult)
-    return std::move(*maybeResult);
-  return nullptr;
+  return parseProgram();
 }
 
+// NOTE: every statement gets a program, arena and spans of its own, so that
+// none of them outlives it but the bodies of the functions it declares
 std::optional<std::unique_ptr<node::Node>> Parser::parse() {
-  return parseProgram();
+  auto program = newProgram();
+  arena::Arena::Scope scope(*program->arena);
+  auto statement = parseStatement();
+  if (!statement) {
+    expect(token::TokenType::END_OF_FILE);
+    return std::nullopt;
+  }
+  program->statements.push_back(std::move(statement));
+  return program;
+}
+
+void Parser::start() {
+  do {
+    next = lexer.nextLexem();
+  } while (next.token.getTokenType() == token::TokenType::ONE_LINE_COMMENT ||
+           next.token.getTokenType() == token::TokenType::MULTILINE_COMMENT);
+  nextEnd = {static_cast<uint32_t>(lexer.currentLine()),
+             static_cast<uint32_t>(lexer.currentColumn())};
+  readLex();
 }
 
 void Parser::readLex() {
+  lastEnd = currentEnd;
   current = next;
+  currentEnd = nextEnd;
   if (current == token::TokenType::END_OF_FILE) {
     return;
   }
@@ -690,6 +796,8 @@ void Parser::readLex() {
     next = lexer.nextLexem();
   } while (next == token::TokenType::ONE_LINE_COMMENT ||
            next == token::TokenType::MULTILINE_COMMENT);
+  nextEnd = {static_cast<uint32_t>(lexer.currentLine()),
+             static_cast<uint32_t>(lexer.currentColumn())};
 }
 
 } // namespace pheonix::parser
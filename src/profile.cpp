@@ -0,0 +1,168 @@
+#include "profile.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+namespace pheonix::profile {
+
+namespace {
+
+double milliseconds(std::chrono::nanoseconds time) {
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+} // namespace
+
+Profiler::Profiler(std::chrono::microseconds interval, Clock clock)
+    : interval(interval), clock(std::move(clock)), pending(false),
+      running(false), timer(), last(), samples(0), stack(), functions(),
+      lines(), stacks() {}
+
+Profiler::~Profiler() { stop(); }
+
+void Profiler::start() {
+  stack.clear();
+  enter(symbol::intern("main"), 0);
+  last = clock();
+  running = true;
+  pending = interval.count() == 0;
+  if (interval.count() == 0)
+    return;
+  timer = std::thread([this] {
+    while (running.load(std::memory_order_relaxed)) {
+      std::this_thread::sleep_for(interval);
+      pending.store(true, std::memory_order_relaxed);
+    }
+  });
+}
+
+void Profiler::stop() {
+  if (!running)
+    return;
+  running = false;
+  if (timer.joinable())
+    timer.join();
+  // NOTE: the time since the last sample is charged as well, so that the
+  // profile covers the whole run
+  if (!stack.empty())
+    sample();
+}
+
+void Profiler::enter(symbol::Symbol function, size_t line) {
+  // NOTE: the time so far belongs to the caller, evaluating the arguments
+  if (!stack.empty() && pending.load(std::memory_order_relaxed))
+    sample();
+  Function key{function, line};
+  Counters &counters = functions[key];
+  ++counters.calls;
+  stack.push_back(Frame{key, &counters, line});
+}
+
+// NOTE: the time since the last sample belongs to the frame left, it is
+// taken before the frame is popped
+void Profiler::leave() {
+  if (pending.load(std::memory_order_relaxed))
+    sample();
+  stack.pop_back();
+}
+
+void Profiler::replace(symbol::Symbol function, size_t line) {
+  leave();
+  enter(function, line);
+}
+
+void Profiler::sample() {
+  pending.store(interval.count() == 0, std::memory_order_relaxed);
+  auto now = clock();
+  auto elapsed = now - last;
+  last = now;
+  ++samples;
+
+  const Frame &top = stack.back();
+  ++top.counters->samples;
+  top.counters->self += elapsed;
+  Counters &line = lines[top.line];
+  ++line.samples;
+  line.self += elapsed;
+
+  std::string path;
+  for (const Frame &frame : stack) {
+    if (frame.counters->charged != samples) {
+      frame.counters->charged = samples;
+      frame.counters->total += elapsed;
+    }
+    Counters &current = lines[frame.line];
+    if (current.charged != samples) {
+      current.charged = samples;
+      current.total += elapsed;
+    }
+    if (!path.empty())
+      path += ';';
+    path += symbol::name(frame.function.name) + ":" +
+            std::to_string(frame.line);
+  }
+  stacks[path] += elapsed;
+}
+
+size_t Profiler::calls(symbol::Symbol function, size_t line) const {
+  auto counters = functions.find(Function{function, line});
+  return counters == functions.end() ? 0 : counters->second.calls;
+}
+
+std::chrono::nanoseconds Profiler::self(size_t line) const {
+  auto counters = lines.find(line);
+  return counters == lines.end() ? std::chrono::nanoseconds(0)
+                                 : counters->second.self;
+}
+
+std::string Profiler::label(const Function &function) const {
+  if (function.line == 0)
+    return symbol::name(function.name);
+  return symbol::name(function.name) + " (line " +
+         std::to_string(function.line) + ")";
+}
+
+void Profiler::report(std::ostream &os) const {
+  std::vector<std::pair<Function, Counters>> byFunction(functions.begin(),
+                                                        functions.end());
+  std::sort(byFunction.begin(), byFunction.end(),
+            [](const auto &a, const auto &b) {
+              return a.second.self > b.second.self;
+            });
+  std::vector<std::pair<size_t, Counters>> byLine(lines.begin(), lines.end());
+  std::stable_sort(byLine.begin(), byLine.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.second.self > b.second.self;
+                   });
+
+  os << "flat profile: " << samples << " samples every "
+     << interval.count() << "us\n\n";
+  os << std::fixed << std::setprecision(3);
+  os << std::setw(12) << "self ms" << std::setw(12) << "total ms"
+     << std::setw(10) << "samples" << std::setw(10) << "calls"
+     << "  function\n";
+  for (const auto &[function, counters] : byFunction)
+    os << std::setw(12) << milliseconds(counters.self) << std::setw(12)
+       << milliseconds(counters.total) << std::setw(10) << counters.samples
+       << std::setw(10) << counters.calls << "  " << label(function) << "\n";
+  os << "\n";
+  os << std::setw(12) << "self ms" << std::setw(12) << "total ms"
+     << std::setw(10) << "samples"
+     << "  line\n";
+  for (const auto &[line, counters] : byLine)
+    os << std::setw(12) << milliseconds(counters.self) << std::setw(12)
+       << milliseconds(counters.total) << std::setw(10) << counters.samples
+       << "  " << line << "\n";
+  os << std::defaultfloat;
+}
+
+void Profiler::folded(std::ostream &os) const {
+  for (const auto &[path, time] : stacks) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(time);
+    if (us.count() > 0)
+      os << path << " " << us.count() << "\n";
+  }
+}
+
+} // namespace pheonix::profile
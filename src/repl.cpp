@@ -1,5 +1,6 @@
 #include "repl.hpp"
 
+#include <exception>
 #include <iostream>
 #include <stack>
 #include <string>
@@ -47,7 +48,6 @@ void repl() {
   std::string line;
   std::stack<char> brackets;
   pheonix::eval::Evaluator evaluator;
-  pheonix::eval::Evaluator prev_evaluator;
   std::unique_ptr<pheonix::node::Node> output;
   bool in_scope = false;
 
@@ -62,10 +62,16 @@ void repl() {
 
     if (_checkBrackets(line, brackets)) {
       if (_canCloseAllBrackets(brackets)) {
-        pheonix::parser::Parser p(buffer);
-        output = p.generateParsingTree();
-        prev_evaluator.setContext(evaluator.getContext());
-        output->accept(evaluator);
+        // NOTE: a line which fails leaves the state as it was before it
+        evaluator.checkpoint();
+        try {
+          pheonix::parser::Parser p(buffer);
+          output = p.generateParsingTree();
+          output->accept(evaluator);
+        } catch (const std::exception &e) {
+          std::cout << "Error: " << e.what() << "\n";
+          evaluator.rollback();
+        }
         buffer.str("");
         buffer.clear();
         in_scope = false;
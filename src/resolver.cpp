@@ -0,0 +1,194 @@
+#include "resolver.hpp"
+
+namespace pheonix::resolver {
+
+Resolver::Resolver() : visitor::Visitor(), scope(nullptr), loops(0) {}
+
+void Resolver::resolve(node::Node &root) {
+  scope = nullptr;
+  loops = 0;
+  root.accept(*this);
+}
+
+void Resolver::visit(node::Program &p) {
+  for (size_t i = 0; i < p.statements.size(); ++i)
+    p.statements[i]->accept(*this);
+}
+
+void Resolver::visit(node::Parameter &p) {
+  // NOTE: every parameter gets its own slot, even a repeated name
+  scope->layout.symbols.push_back(p.symbol);
+  scope->slots[p.symbol] = scope->layout.symbols.size() - 1;
+}
+
+void Resolver::visit(node::DeclarationArguments &da) {
+  for (size_t i = 0; i < da.arguments.size(); ++i)
+    da.arguments[i]->accept(*this);
+}
+
+void Resolver::visit(node::Block &b) {
+  for (size_t i = 0; i < b.statements.size(); ++i)
+    b.statements[i]->accept(*this);
+}
+
+void Resolver::visit(node::FunctionDeclaration &fd) {
+  fd.slot = declare(fd.symbol);
+  fd.layout = function(*fd.arguments, *fd.statements);
+}
+
+void Resolver::visit(node::VariableDeclaration &vd) {
+  vd.expression->accept(*this);
+  vd.slot = declare(vd.symbol);
+}
+
+void Resolver::visit(node::WhileLoopStatement &wls) {
+  wls.expression->accept(*this);
+  // NOTE: a return does not stop a loop, so what it returns is not the last
+  // thing the function does
+  ++loops;
+  wls.statements->accept(*this);
+  --loops;
+}
+
+void Resolver::visit(node::IfStatement &is) {
+  is.predicate->accept(*this);
+  is.ifBody->accept(*this);
+  if (is.elseBody)
+    is.elseBody->accept(*this);
+}
+
+void Resolver::visit(node::ReturnStatement &rs) {
+  if (!rs.expression)
+    return;
+  rs.expression->accept(*this);
+  if (auto *call = dynamic_cast<node::CallExpression *>(rs.expression.get()))
+    call->tail = scope && loops == 0;
+}
+
+void Resolver::visit(node::ExpressionStatement &es) {
+  es.expression->accept(*this);
+}
+
+void Resolver::visit(node::NullStatement &) {}
+
+void Resolver::visit(node::AssignementExpression &ae) {
+  use(ae.symbol, ae.depth, ae.slot);
+  ae.expression->accept(*this);
+}
+
+void Resolver::visit(node::OrExpression &oe) {
+  oe.left->accept(*this);
+  oe.right->accept(*this);
+}
+
+void Resolver::visit(node::AndExpression &ae) {
+  ae.left->accept(*this);
+  ae.right->accept(*this);
+}
+
+void Resolver::visit(node::ComparisonExpression &ce) {
+  ce.left->accept(*this);
+  ce.right->accept(*this);
+}
+
+void Resolver::visit(node::RelationalExpression &re) {
+  re.left->accept(*this);
+  re.right->accept(*this);
+}
+
+void Resolver::visit(node::MultiplicativeExpression &me) {
+  me.left->accept(*this);
+  me.right->accept(*this);
+}
+
+void Resolver::visit(node::CompositiveExpression &ce) {
+  ce.left->accept(*this);
+  ce.right->accept(*this);
+}
+
+void Resolver::visit(node::AdditiveExpression &ae) {
+  ae.left->accept(*this);
+  ae.right->accept(*this);
+}
+
+void Resolver::visit(node::CastExpression &ce) {
+  ce.expression->accept(*this);
+}
+
+void Resolver::visit(node::PrefixExpression &pe) {
+  pe.expression->accept(*this);
+}
+
+void Resolver::visit(node::CallExpression &ce) {
+  ce.function->accept(*this);
+  ce.arguments->accept(*this);
+}
+
+void Resolver::visit(node::DebugExpression &de) {
+  de.function->accept(*this);
+  de.arguments->accept(*this);
+}
+
+void Resolver::visit(node::CallArguments &ca) {
+  for (size_t i = 0; i < ca.arguments.size(); ++i)
+    ca.arguments[i]->accept(*this);
+}
+
+void Resolver::visit(node::LambdaExpression &le) {
+  le.layout = function(*le.arguments, *le.statements);
+}
+
+void Resolver::visit(node::Identifier &i) { use(i.symbol, i.depth, i.slot); }
+
+void Resolver::visit(node::ParentExpression &pe) {
+  pe.expression->accept(*this);
+}
+
+void Resolver::visit(node::Literal &) {}
+
+void Resolver::visit(node::TypeSpecifier &) {}
+
+void Resolver::visit(node::PrintFunction &) {}
+
+std::shared_ptr<const symbol::Layout>
+Resolver::function(node::Node &arguments, node::Node &statements) {
+  Scope *enclosing = scope;
+  size_t enclosingLoops = loops;
+  Scope function;
+  scope = &function;
+  loops = 0;
+  arguments.accept(*this);
+  statements.accept(*this);
+  scope = enclosing;
+  loops = enclosingLoops;
+  return std::make_shared<const symbol::Layout>(std::move(function.layout));
+}
+
+size_t Resolver::declare(symbol::Symbol symbol) {
+  if (!scope)
+    return symbol;
+  auto it = scope->slots.find(symbol);
+  if (it != scope->slots.end())
+    return it->second;
+  scope->layout.symbols.push_back(symbol);
+  scope->slots[symbol] = scope->layout.symbols.size() - 1;
+  return scope->layout.symbols.size() - 1;
+}
+
+void Resolver::use(symbol::Symbol symbol, size_t &depth, size_t &slot) {
+  if (!scope) {
+    depth = 0;
+    slot = symbol;
+    return;
+  }
+  auto it = scope->slots.find(symbol);
+  if (it == scope->slots.end()) {
+    depth = symbol::UNRESOLVED;
+    slot = 0;
+    return;
+  }
+  depth = 0;
+  slot = it->second;
+}
+
+} // namespace pheonix::resolver
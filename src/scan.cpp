@@ -0,0 +1,200 @@
+#include "scan.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if (defined(__GNUC__) || defined(__clang__)) &&                              \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <immintrin.h>
+#define PHEONIX_X86_SIMD
+#endif
+
+namespace pheonix::lexer::scan {
+
+namespace {
+
+enum Run { SPACES, IDENTIFIER, LINE, COMMENT, RUNS };
+
+constexpr char END_OF_FILE = static_cast<char>(EOF);
+
+// NOTE: same as isalnum in the "C" locale, other bytes end an identifier
+template <Run R> bool belongs(char c) {
+  if constexpr (R == SPACES)
+    return c == ' ' || c == '\t';
+  else if constexpr (R == IDENTIFIER)
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+           (c >= 'A' && c <= 'Z') || c == '_';
+  else if constexpr (R == LINE)
+    return c != '\n' && c != '\r' && c != END_OF_FILE;
+  else
+    return c != '\n' && c != '\r' && c != END_OF_FILE && c != '*';
+}
+
+template <Run R> const char *scalar(const char *begin, const char *end) {
+  while (begin != end && belongs<R>(*begin))
+    ++begin;
+  return begin;
+}
+
+using Kernel = const char *(*)(const char *, const char *);
+
+constexpr Kernel SCALAR[RUNS] = {scalar<SPACES>, scalar<IDENTIFIER>,
+                                 scalar<LINE>, scalar<COMMENT>};
+
+#ifdef PHEONIX_X86_SIMD
+
+// Vector kernels compute a mask of bytes which end the run, 16 or 32 at a
+// time, and leave the remaining tail to the scalar kernel.
+
+__m128i sse2Is(__m128i v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+// signed comparison, bytes above 127 are negative and never in range
+__m128i sse2Within(__m128i v, char low, char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(low - 1)),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(high + 1)));
+}
+
+template <Run R> uint32_t sse2Stops(__m128i v) {
+  __m128i mask;
+  if constexpr (R == SPACES) {
+    mask = _mm_or_si128(sse2Is(v, ' '), sse2Is(v, '\t'));
+  } else if constexpr (R == IDENTIFIER) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    mask = _mm_or_si128(_mm_or_si128(sse2Within(v, '0', '9'), sse2Is(v, '_')),
+                        sse2Within(lower, 'a', 'z'));
+  } else {
+    mask = _mm_or_si128(_mm_or_si128(sse2Is(v, '\n'), sse2Is(v, '\r')),
+                        sse2Is(v, END_OF_FILE));
+    if constexpr (R == COMMENT)
+      mask = _mm_or_si128(mask, sse2Is(v, '*'));
+  }
+  auto bits = static_cast<uint32_t>(_mm_movemask_epi8(mask));
+  if constexpr (R == SPACES || R == IDENTIFIER)
+    return ~bits & 0xffff;
+  return bits;
+}
+
+template <Run R> const char *sse2(const char *begin, const char *end) {
+  while (end - begin >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    if (uint32_t stops = sse2Stops<R>(v))
+      return begin + __builtin_ctz(stops);
+    begin += 16;
+  }
+  return scalar<R>(begin, end);
+}
+
+__attribute__((target("avx2"))) __m256i avx2Is(__m256i v, char c) {
+  return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) __m256i avx2Within(__m256i v, char low,
+                                                   char high) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(low - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), v));
+}
+
+template <Run R>
+__attribute__((target("avx2"))) uint32_t avx2Stops(__m256i v) {
+  __m256i mask;
+  if constexpr (R == SPACES) {
+    mask = _mm256_or_si256(avx2Is(v, ' '), avx2Is(v, '\t'));
+  } else if constexpr (R == IDENTIFIER) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    mask = _mm256_or_si256(
+        _mm256_or_si256(avx2Within(v, '0', '9'), avx2Is(v, '_')),
+        avx2Within(lower, 'a', 'z'));
+  } else {
+    mask = _mm256_or_si256(_mm256_or_si256(avx2Is(v, '\n'), avx2Is(v, '\r')),
+                           avx2Is(v, END_OF_FILE));
+    if constexpr (R == COMMENT)
+      mask = _mm256_or_si256(mask, avx2Is(v, '*'));
+  }
+  auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(mask));
+  if constexpr (R == SPACES || R == IDENTIFIER)
+    return ~bits;
+  return bits;
+}
+
+template <Run R>
+__attribute__((target("avx2"))) const char *avx2(const char *begin,
+                                                 const char *end) {
+  while (end - begin >= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    if (uint32_t stops = avx2Stops<R>(v))
+      return begin + __builtin_ctz(stops);
+    begin += 32;
+  }
+  return sse2<R>(begin, end);
+}
+
+constexpr Kernel SSE2[RUNS] = {sse2<SPACES>, sse2<IDENTIFIER>, sse2<LINE>,
+                               sse2<COMMENT>};
+constexpr Kernel AVX2[RUNS] = {avx2<SPACES>, avx2<IDENTIFIER>, avx2<LINE>,
+                               avx2<COMMENT>};
+
+#endif
+
+const Kernel *kernelsFor(Isa isa) {
+#ifdef PHEONIX_X86_SIMD
+  if (isa == Isa::AVX2)
+    return AVX2;
+  if (isa == Isa::SSE2)
+    return SSE2;
+#endif
+  (void)isa;
+  return SCALAR;
+}
+
+Isa selected = best();
+const Kernel *kernels = kernelsFor(selected);
+
+} // namespace
+
+bool supported(Isa isa) {
+#ifdef PHEONIX_X86_SIMD
+  if (isa == Isa::AVX2) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }
+  return true;
+#else
+  return isa == Isa::SCALAR;
+#endif
+}
+
+Isa best() {
+  if (supported(Isa::AVX2))
+    return Isa::AVX2;
+  if (supported(Isa::SSE2))
+    return Isa::SSE2;
+  return Isa::SCALAR;
+}
+
+Isa current() { return selected; }
+
+void use(Isa isa) {
+  selected = isa;
+  kernels = kernelsFor(isa);
+}
+
+const char *spaces(const char *begin, const char *end) {
+  return kernels[SPACES](begin, end);
+}
+
+const char *identifier(const char *begin, const char *end) {
+  return kernels[IDENTIFIER](begin, end);
+}
+
+const char *lineEnd(const char *begin, const char *end) {
+  return kernels[LINE](begin, end);
+}
+
+const char *commentEnd(const char *begin, const char *end) {
+  return kernels[COMMENT](begin, end);
+}
+
+} // namespace pheonix::lexer::scan
@@ -0,0 +1,47 @@
+#include "source_file.hpp"
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PHEONIX_MMAP
+#endif
+
+namespace pheonix::lexer {
+
+SourceFile::SourceFile(const std::string &path)
+    : data(nullptr), size(0), isOpen(false), isMapped(false), file() {
+#ifdef PHEONIX_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat status;
+  if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) &&
+      status.st_size > 0) {
+    size = static_cast<size_t>(status.st_size);
+    void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped != MAP_FAILED) {
+      ::madvise(mapped, size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(mapped);
+      isMapped = isOpen = true;
+    }
+  }
+  ::close(fd);
+  if (isMapped)
+    return;
+  size = 0;
+#endif
+  // NOTE: empty files and special files cannot be mapped
+  file.open(path, std::ios::binary);
+  isOpen = static_cast<bool>(file);
+}
+
+SourceFile::~SourceFile() {
+#ifdef PHEONIX_MMAP
+  if (isMapped)
+    ::munmap(const_cast<char *>(data), size);
+#endif
+}
+
+} // namespace pheonix::lexer
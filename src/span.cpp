@@ -0,0 +1,22 @@
+#include "span.hpp"
+
+namespace pheonix::node {
+
+std::ostream &operator<<(std::ostream &os, const Position &position) {
+  return os << position.line << ":" << position.column;
+}
+
+Spans::Spans() : spans(1) {}
+
+uint32_t Spans::add(const Span &span) {
+  spans.push_back(span);
+  return static_cast<uint32_t>(spans.size() - 1);
+}
+
+const Span *Spans::find(uint32_t id) const {
+  if (id == NONE || id >= spans.size())
+    return nullptr;
+  return &spans[id];
+}
+
+} // namespace pheonix::node
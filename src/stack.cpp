@@ -0,0 +1,171 @@
+#include "stack.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<ucontext.h>)
+#include <pthread.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define PHEONIX_STACK_SEGMENTS
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define PHEONIX_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define PHEONIX_ASAN
+#endif
+#endif
+
+#ifdef PHEONIX_ASAN
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+namespace pheonix::stack {
+
+#ifdef PHEONIX_STACK_SEGMENTS
+
+namespace {
+
+// NOTE: enough for everything that runs between two checks, e.g. deeply
+// nested expressions of a single statement
+constexpr size_t RED_ZONE = 256 << 10;
+constexpr size_t SEGMENT = 8 << 20;
+
+// lowest address the current stack may reach, nullptr when unknown
+thread_local const char *limit = nullptr;
+thread_local bool limitKnown = false;
+
+const char *nativeLimit() {
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+    return nullptr;
+  void *address = nullptr;
+  size_t size = 0;
+  int status = pthread_attr_getstack(&attributes, &address, &size);
+  pthread_attr_destroy(&attributes);
+  if (status != 0 || size <= RED_ZONE)
+    return nullptr;
+  return static_cast<const char *>(address) + RED_ZONE;
+}
+
+size_t guardSize() { return static_cast<size_t>(::sysconf(_SC_PAGESIZE)); }
+
+// NOTE: segments are kept for the next deep recursion of the thread
+struct Segments {
+  std::vector<char *> spare;
+
+  char *take() {
+    if (!spare.empty()) {
+      char *segment = spare.back();
+      spare.pop_back();
+      return segment;
+    }
+    void *memory = ::mmap(nullptr, guardSize() + SEGMENT,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED)
+      throw std::bad_alloc();
+    // overflowing the segment faults instead of overwriting memory
+    ::mprotect(memory, guardSize(), PROT_NONE);
+    return static_cast<char *>(memory);
+  }
+
+  void give(char *segment) { spare.push_back(segment); }
+
+  ~Segments() {
+    for (char *segment : spare)
+      ::munmap(segment, guardSize() + SEGMENT);
+  }
+};
+
+thread_local Segments segments;
+
+struct Call {
+  void (*function)(void *);
+  void *argument;
+  std::exception_ptr exception;
+  ucontext_t caller;
+  ucontext_t callee;
+  // bounds of the caller's stack, for the address sanitizer
+  const void *callerBottom;
+  size_t callerSize;
+};
+
+thread_local Call *starting = nullptr;
+
+void trampoline() {
+  Call *call = starting;
+#ifdef PHEONIX_ASAN
+  __sanitizer_finish_switch_fiber(nullptr, &call->callerBottom,
+                                  &call->callerSize);
+#endif
+  try {
+    call->function(call->argument);
+  } catch (...) {
+    call->exception = std::current_exception();
+  }
+#ifdef PHEONIX_ASAN
+  __sanitizer_start_switch_fiber(nullptr, call->callerBottom,
+                                 call->callerSize);
+#endif
+  ::swapcontext(&call->callee, &call->caller);
+}
+
+// NOTE: getcontext returns twice, locals of its caller must not be live
+// across it
+__attribute__((noinline)) void prepare(Call &call, char *bottom) {
+  ::getcontext(&call.callee);
+  call.callee.uc_stack.ss_sp = bottom;
+  call.callee.uc_stack.ss_size = SEGMENT;
+  call.callee.uc_link = nullptr;
+  ::makecontext(&call.callee, trampoline, 0);
+}
+
+} // namespace
+
+bool low() {
+  if (!limitKnown) {
+    limit = nativeLimit();
+    limitKnown = true;
+  }
+  return limit &&
+         static_cast<const char *>(__builtin_frame_address(0)) < limit;
+}
+
+void grow(void (*function)(void *), void *argument) {
+  char *segment = segments.take();
+  char *bottom = segment + guardSize();
+  Call call{function, argument, nullptr, {}, {}, nullptr, 0};
+  prepare(call, bottom);
+
+  const char *previous = limit;
+  limit = bottom + RED_ZONE;
+  starting = &call;
+#ifdef PHEONIX_ASAN
+  void *fakeStack = nullptr;
+  __sanitizer_start_switch_fiber(&fakeStack, bottom, SEGMENT);
+#endif
+  ::swapcontext(&call.caller, &call.callee);
+#ifdef PHEONIX_ASAN
+  __sanitizer_finish_switch_fiber(fakeStack, nullptr, nullptr);
+#endif
+  limit = previous;
+  segments.give(segment);
+  if (call.exception)
+    std::rethrow_exception(call.exception);
+}
+
+#else
+
+bool low() { return false; }
+
+void grow(void (*function)(void *), void *argument) { function(argument); }
+
+#endif
+
+} // namespace pheonix::stack
@@ -0,0 +1,188 @@
+#include "string.hpp"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace pheonix::types {
+
+// A flat buffer has its characters right after the header. A rope has its
+// two operands there until it is flattened, its characters are then
+// allocated apart.
+struct String::Rep {
+  uint32_t refs;
+  bool rope;
+  size_t size;
+  // nullptr for a rope which was not flattened yet
+  char *chars;
+
+  String *operands() { return reinterpret_cast<String *>(this + 1); }
+
+  static Rep *allocate(size_t size) {
+    static_assert(alignof(Rep) > 1);
+    void *memory = ::operator new(sizeof(Rep) + size);
+    Rep *rep = new (memory) Rep{1, false, size, nullptr};
+    rep->chars = reinterpret_cast<char *>(rep + 1);
+    return rep;
+  }
+
+  static Rep *allocateRope(const String &lhs, const String &rhs) {
+    void *memory = ::operator new(sizeof(Rep) + 2 * sizeof(String));
+    Rep *rep =
+        new (memory) Rep{1, true, lhs.size() + rhs.size(), nullptr};
+    new (rep->operands()) String(lhs);
+    new (rep->operands() + 1) String(rhs);
+    return rep;
+  }
+};
+
+String::String() : bytes() { bytes[TAG] = 1; }
+
+String::String(std::string_view value) : String() {
+  if (value.size() <= INLINE) {
+    bytes[TAG] = static_cast<unsigned char>(value.size() << 1 | 1);
+    std::memcpy(bytes + CHARS, value.data(), value.size());
+    return;
+  }
+  Rep *rep = Rep::allocate(value.size());
+  std::memcpy(rep->chars, value.data(), value.size());
+  setRep(rep);
+}
+
+String::String(const String &other) : String() {
+  std::memcpy(bytes, other.bytes, sizeof(bytes));
+  if (!isInline())
+    ++rep()->refs;
+}
+
+String::String(String &&other) noexcept : String() {
+  std::memcpy(bytes, other.bytes, sizeof(bytes));
+  other.bytes[TAG] = 1;
+}
+
+String &String::operator=(const String &other) {
+  if (this != &other) {
+    String copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+String &String::operator=(String &&other) noexcept {
+  if (this != &other) {
+    release();
+    std::memcpy(bytes, other.bytes, sizeof(bytes));
+    other.bytes[TAG] = 1;
+  }
+  return *this;
+}
+
+String::~String() { release(); }
+
+String String::concat(const String &lhs, const String &rhs) {
+  if (rhs.empty())
+    return lhs;
+  if (lhs.empty())
+    return rhs;
+  String result;
+  size_t size = lhs.size() + rhs.size();
+  if (size >= ROPE) {
+    result.setRep(Rep::allocateRope(lhs, rhs));
+    return result;
+  }
+  char *chars;
+  if (size <= INLINE) {
+    result.bytes[TAG] = static_cast<unsigned char>(size << 1 | 1);
+    chars = reinterpret_cast<char *>(result.bytes + CHARS);
+  } else {
+    Rep *rep = Rep::allocate(size);
+    result.setRep(rep);
+    chars = rep->chars;
+  }
+  std::memcpy(chars, lhs.data(), lhs.size());
+  std::memcpy(chars + lhs.size(), rhs.data(), rhs.size());
+  return result;
+}
+
+size_t String::size() const {
+  return isInline() ? bytes[TAG] >> 1 : rep()->size;
+}
+
+const char *String::data() const {
+  if (isInline())
+    return reinterpret_cast<const char *>(bytes + CHARS);
+  Rep *shared = rep();
+  if (!shared->chars)
+    flatten(shared);
+  return shared->chars;
+}
+
+String::Rep *String::rep() const {
+  Rep *rep;
+  std::memcpy(&rep, bytes, sizeof(rep));
+  return rep;
+}
+
+void String::setRep(Rep *rep) { std::memcpy(bytes, &rep, sizeof(rep)); }
+
+void String::release() {
+  if (!isInline()) {
+    Rep *shared = rep();
+    if (--shared->refs == 0)
+      destroy(shared);
+    bytes[TAG] = 1;
+  }
+}
+
+// NOTE: ropes built in a loop are as deep as the loop was long, so they are
+// walked with a stack of their own, not by recursion
+void String::destroy(Rep *rep) {
+  if (!rep->rope || rep->chars) {
+    if (rep->rope)
+      delete[] rep->chars;
+    ::operator delete(rep);
+    return;
+  }
+  std::vector<Rep *> pending{rep};
+  while (!pending.empty()) {
+    Rep *current = pending.back();
+    pending.pop_back();
+    if (current->rope && current->chars) {
+      delete[] current->chars;
+    } else if (current->rope) {
+      for (String *operand = current->operands();
+           operand != current->operands() + 2; ++operand) {
+        if (!operand->isInline() && --operand->rep()->refs == 0)
+          pending.push_back(operand->rep());
+      }
+    }
+    ::operator delete(current);
+  }
+}
+
+void String::flatten(Rep *rep) {
+  char *chars = new char[rep->size];
+  size_t position = 0;
+  std::vector<const String *> pending{rep->operands() + 1, rep->operands()};
+  while (!pending.empty()) {
+    const String *current = pending.back();
+    pending.pop_back();
+    if (current->isInline() || current->rep()->chars) {
+      std::memcpy(chars + position, current->data(), current->size());
+      position += current->size();
+    } else {
+      pending.push_back(current->rep()->operands() + 1);
+      pending.push_back(current->rep()->operands());
+    }
+  }
+  for (String *operand = rep->operands(); operand != rep->operands() + 2;
+       ++operand)
+    operand->~String();
+  rep->chars = chars;
+}
+
+std::ostream &operator<<(std::ostream &os, const String &string) {
+  return os << string.view();
+}
+
+} // namespace pheonix::types
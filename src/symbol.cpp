@@ -0,0 +1,46 @@
+#include "symbol.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+namespace pheonix::symbol {
+
+namespace {
+
+// allows lookups by std::string_view without making a std::string
+struct NameHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view name) const {
+    return std::hash<std::string_view>{}(name);
+  }
+};
+
+struct SymbolTable {
+  // NOTE: deque keeps references returned by `name` valid
+  std::deque<std::string> names;
+  std::unordered_map<std::string, Symbol, NameHash, std::equal_to<>> symbols;
+};
+
+SymbolTable &table() {
+  static SymbolTable table;
+  return table;
+}
+
+} // namespace
+
+Symbol intern(std::string_view name) {
+  auto &t = table();
+  auto it = t.symbols.find(name);
+  if (it != t.symbols.end())
+    return it->second;
+  auto symbol = static_cast<Symbol>(t.names.size());
+  t.names.emplace_back(name);
+  t.symbols.emplace(t.names.back(), symbol);
+  return symbol;
+}
+
+const std::string &name(Symbol symbol) { return table().names.at(symbol); }
+
+size_t count() { return table().names.size(); }
+
+} // namespace pheonix::symbol
@@ -7,10 +7,12 @@ std::ostream &operator<<(std::ostream &os, const Primitive &value) {
     os << std::get<types::Integer>(value).getValue();
   } else if (std::holds_alternative<types::Float>(value)) {
     os << std::get<types::Float>(value).getValue();
-  } else if (std::holds_alternative<std::string>(value)) {
-    os << std::get<std::string>(value);
+  } else if (std::holds_alternative<types::String>(value)) {
+    os << std::get<types::String>(value);
   } else if (std::holds_alternative<bool>(value)) {
     os << (std::get<bool>(value) ? "true" : "false");
+  } else if (std::holds_alternative<types::BigInt>(value)) {
+    os << std::get<types::BigInt>(value);
   } else {
     os << "[]";
   }
@@ -21,12 +23,33 @@ std::ostream &operator<<(std::ostream &os, const Primitive &value) {
 
 namespace pheonix::token {
 
+Token::Token(TokenType t, const std::string &val)
+    : tokenType(t), value(), symbol(0) {
+  if (t == TokenType::IDENTIFIER)
+    symbol = symbol::intern(val);
+  else
+    value = val;
+}
+
+Token Token::identifier(symbol::Symbol symbol) {
+  Token token(TokenType::IDENTIFIER);
+  token.symbol = symbol;
+  return token;
+}
+
 TokenType Token::getTokenType() const { return tokenType; }
 
-Primitive Token::getValue() const { return value; }
+Primitive Token::getValue() const {
+  if (tokenType == TokenType::IDENTIFIER)
+    return symbol::name(symbol);
+  return value;
+}
+
+symbol::Symbol Token::getSymbol() const { return symbol; }
 
 bool Token::operator==(const Token &t) const {
-  return this->tokenType == t.tokenType && this->value == t.value;
+  return this->tokenType == t.tokenType && this->value == t.value &&
+         this->symbol == t.symbol;
 }
 
 std::ostream &operator<<(std::ostream &os, const Token &t) {
@@ -1,11 +1,20 @@
 #include "types.hpp"
 
-#include <limits>
 #include <stdexcept>
 
 namespace pheonix::types {
 
-Integer &Integer::operator=(int val) {
+namespace {
+
+OverflowPolicy policy = OverflowPolicy::PROMOTE;
+
+} // namespace
+
+void setOverflowPolicy(OverflowPolicy overflow) { policy = overflow; }
+
+OverflowPolicy overflowPolicy() { return policy; }
+
+Integer &Integer::operator=(int64_t val) {
   value = val;
   return *this;
 }
@@ -15,31 +24,49 @@ Integer &Integer::operator=(const Integer &val) {
   return *this;
 }
 
-Integer &Integer::operator*=(int val) {
-  setValue(static_cast<long>(value) * static_cast<long>(val));
+namespace {
+
+void overflow() { throw std::runtime_error("Integer overflow."); }
+
+} // namespace
+
+Integer &Integer::operator*=(int64_t val) {
+  if (mulOverflow(val, *this))
+    overflow();
   return *this;
 }
-Integer &Integer::operator/=(int val) {
-  if (val == 0)
-    throw std::runtime_error("Division by zero");
-  setValue(static_cast<long>(value) / static_cast<long>(val));
+Integer &Integer::operator/=(int64_t val) {
+  if (divOverflow(val, *this))
+    overflow();
   return *this;
 }
-Integer &Integer::operator+=(int val) {
-  setValue(static_cast<long>(value) + static_cast<long>(val));
+Integer &Integer::operator+=(int64_t val) {
+  if (addOverflow(val, *this))
+    overflow();
   return *this;
 }
-Integer &Integer::operator-=(int val) {
-  setValue(static_cast<long>(value) - static_cast<long>(val));
+Integer &Integer::operator-=(int64_t val) {
+  if (subOverflow(val, *this))
+    overflow();
   return *this;
 }
-Integer &Integer::operator%=(int val) {
+Integer &Integer::operator%=(int64_t val) {
   if (val == 0)
     throw std::runtime_error("Modulo by zero");
-  setValue(static_cast<long>(value) % static_cast<long>(val));
+  // NOTE: the quotient of the minimum by -1 overflows, the remainder is 0
+  value = val == -1 ? 0 : value % val;
   return *this;
 }
 
+bool Integer::divOverflow(const Integer &other, Integer &result) const {
+  if (other.value == 0)
+    throw std::runtime_error("Division by zero");
+  if (other.value == -1)
+    return negOverflow(result);
+  result.value = value / other.value;
+  return false;
+}
+
 Integer &Integer::operator*=(const Integer &val) {
   return (*this) *= val.value;
 }
@@ -53,23 +80,23 @@ Integer &Integer::operator-=(const Integer &val) {
   return (*this) -= val.value;
 }
 
-Integer Integer::operator*(int val) const {
+Integer Integer::operator*(int64_t val) const {
   Integer res(*this);
   return res *= val;
 }
-Integer Integer::operator/(int val) const {
+Integer Integer::operator/(int64_t val) const {
   Integer res(*this);
   return res /= val;
 }
-Integer Integer::operator+(int val) const {
+Integer Integer::operator+(int64_t val) const {
   Integer res(*this);
   return res += val;
 }
-Integer Integer::operator-(int val) const {
+Integer Integer::operator-(int64_t val) const {
   Integer res(*this);
   return res -= val;
 }
-Integer Integer::operator%(int val) const {
+Integer Integer::operator%(int64_t val) const {
   Integer res(*this);
   return res %= val;
 }
@@ -114,17 +141,16 @@ bool Integer::operator>=(const Integer &other) const {
   return value >= other.value;
 }
 
-Integer Integer::operator-() const { return Integer(-value); }
+Integer Integer::operator-() const {
+  Integer result;
+  if (negOverflow(result))
+    overflow();
+  return result;
+}
 
-int Integer::getValue() const { return value; }
+int64_t Integer::getValue() const { return value; }
 
-void Integer::setValue(long val) {
-  if (val > std::numeric_limits<int>::max() ||
-      val < std::numeric_limits<int>::min()) {
-    throw std::runtime_error("Integer literal out of range.");
-  }
-  value = static_cast<int>(val);
-}
+void Integer::setValue(int64_t val) { value = val; }
 
 std::ostream &operator<<(std::ostream &os, const Integer &obj) {
   os << obj.value;
@@ -0,0 +1,382 @@
+#include "vm.hpp"
+#include "compiler.hpp"
+#include "exception.hpp"
+#include "operator_visitor.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <variant>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PHEONIX_COMPUTED_GOTO
+#endif
+
+namespace pheonix::vm {
+
+namespace {
+
+// the value holding the called function, found behind references
+const eval::ObjectValue *callable(const eval::Object &object) {
+  if (object.value.type() == eval::ObjectValue::Type::FUN)
+    return &object.value;
+  if (object.value.type() == eval::ObjectValue::Type::REF)
+    return callable(object.value.asReference());
+  return nullptr;
+}
+
+} // namespace
+
+using bytecode::OpCode;
+
+VM::VM()
+    : isDebugging(false), result(), stack(), frames(), context() {
+  // NOTE: same as in Evaluator, user cannot declare variable of such name
+  std::vector<eval::Param> args;
+  args.emplace_back(symbol::intern("0"), false);
+  eval::Function print(args, std::make_unique<node::PrintFunction>());
+  compiler::ensureCompiled(print);
+  context.insert("print", eval::Object(print));
+}
+
+VM::VM(const context::Context &context)
+    : isDebugging(false), result(), stack(), frames(), context(context) {}
+
+eval::Object VM::getResult() { return result; }
+context::Context VM::getContext() { return context.clone(); }
+void VM::setContext(const context::Context &con) { context = con; }
+void VM::setRecursionLimit(size_t limit) { context.setRecursionLimit(limit); }
+
+eval::Object &VM::variable(const bytecode::Instruction &instruction) {
+  if (instruction.c)
+    return context.dynamic(instruction.b);
+  return context.local(instruction.a, instruction.b);
+}
+
+eval::Object VM::pop() {
+  eval::Object object = std::move(stack.back());
+  stack.pop_back();
+  return object;
+}
+
+void VM::run(std::shared_ptr<const bytecode::Chunk> program) {
+  size_t depth = context.depth();
+  stack.clear();
+  frames.clear();
+  frames.push_back(
+      Frame{eval::ObjectValue(), program.get(), 0, nullptr, 0, isDebugging});
+  const bytecode::Chunk *chunk = program.get();
+  const bytecode::Instruction *ip = chunk->code.data();
+
+#ifdef PHEONIX_COMPUTED_GOTO
+  static void *dispatchTable[] = {
+      &&L_CONSTANT,     &&L_LOAD,          &&L_REFERENCE,
+      &&L_DECLARE,      &&L_CHECK_ASSIGN,  &&L_ASSIGN,
+      &&L_BINARY,       &&L_UNARY,         &&L_CAST,
+      &&L_MAKE_FUNCTION, &&L_DEFINE_FUNCTION, &&L_CALL,
+      &&L_DEBUG_CALL,   &&L_POP_RESULT,    &&L_CLEAR_RESULT,
+      &&L_JUMP,         &&L_BRANCH,        &&L_SHORT_CIRCUIT,
+      &&L_RETURN,       &&L_PRINT,         &&L_END,
+  };
+  static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) ==
+                static_cast<size_t>(OpCode::END) + 1);
+// NOTE: computed goto does not run destructors of the handler's locals,
+// so handlers must not keep owning objects alive when dispatching
+#define DISPATCH() goto *dispatchTable[static_cast<size_t>(ip->op)]
+#define CASE(name) L_##name
+#else
+#define DISPATCH() goto dispatch
+#define CASE(name) case OpCode::name
+#endif
+
+#define CURRENT_CHUNK()                                                        \
+  (frames.back().chunk)
+
+  // NOTE: errors are given the position of the statement which raised them
+  try {
+#ifdef PHEONIX_COMPUTED_GOTO
+    DISPATCH();
+#else
+  dispatch:
+    switch (ip->op) {
+#endif
+
+    CASE(CONSTANT) : {
+      stack.push_back(chunk->constants[ip->a]);
+      ++ip;
+      DISPATCH();
+    }
+    CASE(LOAD) : {
+      stack.push_back(variable(*ip));
+      ++ip;
+      DISPATCH();
+    }
+    CASE(REFERENCE) : {
+      eval::Object &target = variable(*ip);
+      stack.emplace_back(eval::ObjectValue::makeReference(target), target.mut);
+      ++ip;
+      DISPATCH();
+    }
+    CASE(DECLARE) : {
+      if (context.contains_in_current_frame(ip->a))
+        throw std::runtime_error("Redeclaration of variable");
+      result = pop();
+      result.mut = ip->b;
+      context.insert(ip->a, result);
+      ++ip;
+      DISPATCH();
+    }
+    CASE(CHECK_ASSIGN) : {
+      if (!context.contains(ip->c ? symbol::UNRESOLVED : 0, ip->a, ip->b))
+        throw std::runtime_error("variable was not declared");
+      if (!variable(*ip).mut)
+        throw std::runtime_error("variable is not mutable.");
+      ++ip;
+      DISPATCH();
+    }
+    CASE(ASSIGN) : {
+      context.assign(ip->c ? symbol::UNRESOLVED : 0, ip->a, ip->b,
+                     stack.back().value);
+      ++ip;
+      DISPATCH();
+    }
+    CASE(BINARY) : {
+      eval::Object &lhs = stack[stack.size() - 2];
+      lhs = eval::binaryOperator(lhs.value, stack.back().value,
+                                 static_cast<types::OperatorType>(ip->a),
+                                 chunk->caches[ip->b]);
+      stack.pop_back();
+      ++ip;
+      DISPATCH();
+    }
+    CASE(UNARY) : {
+      eval::Object &value = stack.back();
+      value = eval::prefixOperator(value.value,
+                                   static_cast<types::OperatorType>(ip->a));
+      ++ip;
+      DISPATCH();
+    }
+    CASE(CAST) : {
+      eval::Object &value = stack.back();
+      value = eval::castOperator(value.value,
+                                 static_cast<types::CastType>(ip->a));
+      ++ip;
+      DISPATCH();
+    }
+    CASE(MAKE_FUNCTION) : {
+      stack.emplace_back(chunk->functions[ip->a]);
+      ++ip;
+      DISPATCH();
+    }
+    CASE(DEFINE_FUNCTION) : {
+      context.insert(ip->a, eval::Object(chunk->functions[ip->b]));
+      result = eval::Object();
+      ++ip;
+      DISPATCH();
+    }
+    CASE(CALL) :
+    CASE(DEBUG_CALL) : {
+      ip = call(ip, *chunk);
+      chunk = CURRENT_CHUNK();
+      DISPATCH();
+    }
+    CASE(POP_RESULT) : {
+      result = pop();
+      if (isDebugging)
+        std::cout << "[" << result.value << "]\n";
+      ++ip;
+      DISPATCH();
+    }
+    CASE(CLEAR_RESULT) : {
+      result = eval::Object();
+      ++ip;
+      DISPATCH();
+    }
+    CASE(JUMP) : {
+      ip = chunk->code.data() + ip->a;
+      DISPATCH();
+    }
+    CASE(BRANCH) : {
+      const eval::Object &predicate = stack.back();
+      if (predicate.value.type() == eval::ObjectValue::Type::BOL) {
+        ip = predicate.value.asBool() ? ip + 1 : chunk->code.data() + ip->a;
+        result = pop();
+        DISPATCH();
+      }
+      ip = chunk->code.data() + ip->b;
+      stack.pop_back();
+      DISPATCH();
+    }
+    CASE(SHORT_CIRCUIT) : {
+      const eval::ObjectValue &left = eval::dereference(stack.back().value);
+      if (left.type() == eval::ObjectValue::Type::BOL &&
+          left.asBool() == static_cast<bool>(ip->b)) {
+        stack.back() = eval::Object(eval::ObjectValue(left.asBool()));
+        ip = chunk->code.data() + ip->a;
+        DISPATCH();
+      }
+      ++ip;
+      DISPATCH();
+    }
+    CASE(RETURN) : {
+      result = pop();
+      if (isDebugging)
+        std::cout << "[return: " << result.value << "]\n";
+      goto end;
+    }
+    CASE(PRINT) : {
+      result = context.local(0, ip->a);
+      std::cout << result.value << "\n";
+      ++ip;
+      DISPATCH();
+    }
+    CASE(END) : { goto end; }
+
+#ifndef PHEONIX_COMPUTED_GOTO
+    }
+#endif
+
+  end:
+    ip = leave();
+    if (!ip)
+      return;
+    chunk = CURRENT_CHUNK();
+    DISPATCH();
+  } catch (const std::runtime_error &error) {
+    // NOTE: the VM may run again, from the frames it was entered with
+    const node::Span *span = chunk->span(ip);
+    context.unwind(depth);
+    isDebugging = frames.front().wasDebugging;
+    if (!span)
+      throw;
+    throw exception::RuntimeException(error.what(), span->begin.line,
+                                      span->begin.column);
+  }
+
+#undef CURRENT_CHUNK
+#undef CASE
+#undef DISPATCH
+}
+
+const bytecode::Instruction *VM::call(const bytecode::Instruction *ip,
+                                      const bytecode::Chunk &chunk) {
+  const auto &references = chunk.callSites[ip->a];
+  bool debug = ip->op == bytecode::OpCode::DEBUG_CALL;
+  size_t base = stack.size() - references.size();
+  const eval::ObjectValue *called = callable(stack[base - 1]);
+  if (!called)
+    throw std::runtime_error("Called object is not a function.");
+  // NOTE: a copy of the value keeps the function alive while it runs
+  eval::ObjectValue callee = *called;
+  eval::Function *function = &callee.asFunction();
+  if (function->args.size() != references.size())
+    throw std::runtime_error("Wrong number of arguments.");
+  compiler::ensureCompiled(*function);
+
+  bool tail = !debug && ip->b && tailCall(*function, base, references);
+  if (tail)
+    context.pop_frame();
+  context.push_frame(*function->stage(0).layout);
+  if (debug) {
+    std::cout << "[input";
+    if (const node::Span *span = chunk.spans ? chunk.spans->find(ip->b)
+                                             : nullptr)
+      std::cout << " at " << span->begin;
+    std::cout << ": ";
+  }
+  for (size_t i = 0; i < references.size(); ++i) {
+    const auto &param = function->args[i];
+    eval::Object &argument = stack[base + i];
+    // NOTE: a tail call may have replaced a reference with its value
+    if (references[i] &&
+        argument.value.type() == eval::ObjectValue::Type::REF) {
+      auto &target = argument.value.asReference();
+      if (debug)
+        std::cout << target.value;
+      if (param.mut && !target.mut)
+        throw std::runtime_error("variable is not mutable.");
+      context.insertRef(i, target, param.mut);
+    } else {
+      if (debug)
+        std::cout << argument.value;
+      context.insert(i, argument);
+    }
+    if (debug && i + 1 < references.size())
+      std::cout << ", ";
+  }
+  if (debug)
+    std::cout << "]\n";
+
+  if (tail) {
+    // the running frame continues with the called function
+    Frame &frame = frames.back();
+    frame.function = std::move(callee);
+    frame.chunk = function->stage(0).code.get();
+    frame.stage = 0;
+    stack.resize(frame.stackBase);
+  } else {
+    frames.push_back(Frame{std::move(callee), function->stage(0).code.get(),
+                           0, ip + 1, base - 1, isDebugging});
+    stack.resize(base - 1);
+  }
+  isDebugging = isDebugging || debug;
+  result = eval::Object();
+  return frames.back().chunk->code.data();
+}
+
+bool VM::tailCall(const eval::Function &function, size_t base,
+                  const std::vector<bool> &references) {
+  if (frames.size() <= 1 || isDebugging)
+    return false;
+  const Frame &frame = frames.back();
+  if (frame.stage + 1 < frame.function.asFunction().stages() ||
+      !context.replaceableBy(*function.stage(0).layout, references.size()))
+    return false;
+  // NOTE: as in eval::Evaluator, arguments referring to the replaced frame
+  // are passed by value, unless they are references themselves
+  for (size_t i = 0; i < references.size(); ++i) {
+    if (!references[i])
+      continue;
+    const eval::Object &target = stack[base + i].value.asReference();
+    if (context.inCurrentFrame(target) &&
+        (target.value.type() == eval::ObjectValue::Type::REF ||
+         (function.args[i].mut && !target.mut)))
+      return false;
+  }
+  for (size_t i = 0; i < references.size(); ++i) {
+    if (!references[i])
+      continue;
+    const eval::Object &target = stack[base + i].value.asReference();
+    if (context.inCurrentFrame(target))
+      stack[base + i] = eval::Object(target.value, function.args[i].mut);
+  }
+  return true;
+}
+
+const bytecode::Instruction *VM::leave() {
+  Frame &frame = frames.back();
+  stack.resize(frame.stackBase);
+  if (frames.size() == 1) {
+    frames.pop_back();
+    return nullptr;
+  }
+  // NOTE: a reference in the result may point into the frame which is popped
+  result.value = eval::dereference(result.value);
+  // the next stage of a pipeline takes the result in the same frame
+  const eval::Function &function = frame.function.asFunction();
+  if (frame.stage + 1 < function.stages()) {
+    const eval::Stage &stage = function.stage(++frame.stage);
+    frame.chunk = stage.code.get();
+    context.replace_frame(*stage.layout);
+    context.insert(0, result);
+    return frame.chunk->code.data();
+  }
+  context.pop_frame();
+  isDebugging = frame.wasDebugging;
+  const bytecode::Instruction *returnAddress = frame.returnAddress;
+  frames.pop_back();
+  stack.push_back(result);
+  return returnAddress;
+}
+
+} // namespace pheonix::vm
@@ -1,5 +1,10 @@
+#include "allocations.hpp"
+#include "compiler.hpp"
 #include "evaluator.hpp"
+#include "operator_visitor.hpp"
+#include "optimizer.hpp"
 #include "parser.hpp"
+#include "vm.hpp"
 
 #include <gtest/gtest.h>
 
@@ -12,6 +17,8 @@ using namespace pheonix::types;
 using namespace pheonix::context;
 using namespace pheonix::lexer;
 using namespace pheonix::parser;
+using namespace pheonix::compiler;
+using namespace pheonix::vm;
 
 void compareExpectedAndReceived(const string &input,
                                 const ObjectValue &expected) {
@@ -24,6 +31,18 @@ void compareExpectedAndReceived(const string &input,
   EXPECT_EQ(expected, received);
 }
 
+void compareExpectedAndReceivedVM(const string &input,
+                                  const ObjectValue &expected) {
+  istringstream in(input);
+  Parser p(in);
+  unique_ptr<Node> output = p.generateParsingTree();
+  Compiler compiler;
+  VM vm;
+  vm.run(compiler.compile(*output));
+  ObjectValue received = vm.getResult().value;
+  EXPECT_EQ(expected, received);
+}
+
 void compareFunctions(const string &input, const ObjectValue &expected,
                       int size) {
   istringstream in(input);
@@ -39,6 +58,12 @@ void compareFunctions(const string &input, const ObjectValue &expected,
 const map<string, ObjectValue> ARITHMETIC{
     {R"("Kaczka";)", "Kaczka"},
     {"2147483647;", Integer(2147483647)},
+    {"9223372036854775807;", Integer(9223372036854775807)},
+    {"2147483647 + 1;", Integer(2147483648)},
+    {"65536 * 65536;", Integer(4294967296)},
+    {"-9223372036854775807 - 1;", Integer(INT64_MIN)},
+    {"(-9223372036854775807 - 1) % -1;", Integer(0)},
+    {"3000000000.5 <- int;", Integer(3000000000)},
     {"-3;", Integer(-3)},
     {"1 + 2;", Integer(3)},
     {"1 - 2;", Integer(-1)},
@@ -161,9 +186,595 @@ const map<string, ObjectValue> ARITHMETIC{
       is_prime(16);\
    ",
      false},
+    {"let a = 1;let b = 5;fn h(a, b) {return a - b;}h(b, a);", Integer(4)},
+    {"let mut y = 1;\
+      fn g() {y = y + 10;return y;}\
+      fn f(mut y) {return g();}\
+      let mut z = 5;\
+      f(z) + y;",
+     Integer(16)},
+    {"fn apply(f, x) {return f(x);}\
+      let square = #(v){return v * v;};\
+      apply(square, 3 + 1);",
+     Integer(16)},
 };
 TEST(TestEvaluator, testArithmetic) {
   for (const auto &[i, p] : ARITHMETIC) {
     compareExpectedAndReceived(i, p);
   }
 }
+
+TEST(TestVM, testArithmetic) {
+  for (const auto &[i, p] : ARITHMETIC) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// the statements run one at a time as they are parsed, in one engine
+TEST(TestEvaluator, testStreaming) {
+  for (const auto &[i, p] : ARITHMETIC) {
+    istringstream in(i);
+    Parser parser(in);
+    Evaluator visitor;
+    while (auto statement = parser.parse())
+      (*statement)->accept(visitor);
+    EXPECT_EQ(p, visitor.getResult().value) << i;
+  }
+}
+
+TEST(TestVM, testStreaming) {
+  for (const auto &[i, p] : ARITHMETIC) {
+    istringstream in(i);
+    Parser parser(in);
+    Compiler compiler;
+    VM vm;
+    while (auto statement = parser.parse())
+      vm.run(compiler.compile(**statement));
+    EXPECT_EQ(p, vm.getResult().value) << i;
+  }
+}
+
+void evaluate(Evaluator &visitor, const string &input) {
+  istringstream in(input);
+  Parser p(in);
+  unique_ptr<Node> output = p.generateParsingTree();
+  output->accept(visitor);
+}
+
+// state, failing line, check after the failing line was rolled back
+const map<string, tuple<string, string, ObjectValue>> ROLLBACK{
+    {"let mut x = 1;", {"x = 5; y;", "x;", Integer(1)}},
+    {"let a = 1;", {"let b = 2; c;", "let b = 3; a + b;", Integer(4)}},
+    {"let mut x = 1;\
+      fn f(mut a) {a = 7; return a + z;}",
+     {"f(x);", "x;", Integer(1)}},
+};
+
+TEST(TestEvaluator, testRollback) {
+  for (const auto &[state, p] : ROLLBACK) {
+    const auto &[failing, check, expected] = p;
+    Evaluator visitor;
+    evaluate(visitor, state);
+    visitor.checkpoint();
+    EXPECT_ANY_THROW(evaluate(visitor, failing));
+    visitor.rollback();
+    evaluate(visitor, check);
+    EXPECT_EQ(expected, visitor.getResult().value);
+  }
+}
+
+string repeat(const string &piece, int times) {
+  string result;
+  for (int i = 0; i < times; ++i)
+    result += piece;
+  return result;
+}
+
+// strings inline and across the inline limit, values of `str` casts, ropes
+// made by long concatenations, also deep ones
+const map<string, ObjectValue> STRINGS{
+    {"\"\" + \"\";", ""},
+    {"\"abc\" + \"defg\";", "abcdefg"},
+    {"\"abc\" + \"defgh\";", "abcdefgh"},
+    {"let a = \"long enough\"; let b = a; b + \"\" + a;",
+     "long enoughlong enough"},
+    {"(12345678 <- str) + (true <- str);", "12345678true"},
+    {"let mut s = \"\"; let mut i = 0;\
+      while (i < 5) {s = s + (i <- str); i = i + 1;} s;",
+     "01234"},
+    {"let mut s = \"\"; let mut i = 0;\
+      while (i < 200) {s = s + \"ab\"; i = i + 1;} let t = s + s; t;",
+     repeat("ab", 400)},
+    {"let mut s = \"\"; let mut i = 0;\
+      while (i < 100000) {s = s + \"x\"; i = i + 1;} s;",
+     repeat("x", 100000)},
+};
+
+TEST(TestEvaluator, testStrings) {
+  for (const auto &[i, p] : STRINGS) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testStrings) {
+  for (const auto &[i, p] : STRINGS) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// values are moved through the evaluation, so that each step of the loop
+// allocates the new string only, as a single block
+const char *const CONCATENATION_DECLARATIONS =
+    "let mut s = \"\"; let mut i = 0;";
+const char *const CONCATENATION =
+    "while (i < 1000) {s = s + \"abc\"; i = i + 1;}";
+const size_t CONCATENATION_ALLOCATIONS = 1000;
+
+TEST(TestEvaluator, testConcatenationAllocations) {
+  Evaluator visitor;
+  evaluate(visitor, CONCATENATION_DECLARATIONS);
+  istringstream in(CONCATENATION);
+  unique_ptr<Node> loop = Parser(in).generateParsingTree();
+  size_t before = bench::allocations();
+  loop->accept(visitor);
+  size_t allocations = bench::allocations() - before;
+  EXPECT_LE(allocations, CONCATENATION_ALLOCATIONS);
+  evaluate(visitor, "s;");
+  EXPECT_EQ(visitor.getResult().value.asString().size(), 3000);
+}
+
+TEST(TestVM, testConcatenationAllocations) {
+  Compiler compiler;
+  VM vm;
+  istringstream declarations(CONCATENATION_DECLARATIONS);
+  vm.run(compiler.compile(*Parser(declarations).generateParsingTree()));
+  istringstream in(CONCATENATION);
+  auto loop = compiler.compile(*Parser(in).generateParsingTree());
+  size_t before = bench::allocations();
+  vm.run(loop);
+  size_t allocations = bench::allocations() - before;
+  EXPECT_LE(allocations, CONCATENATION_ALLOCATIONS);
+}
+
+const map<string, ObjectValue> RECURSION{
+    {"fn loop(n, acc) {if (n == 0) {return acc;} return loop(n - 1, acc + 2);}\
+      loop(200000, 0);",
+     Integer(400000)},
+    {"fn sum(n) {if (n == 0) {return 0;} return n % 7 + sum(n - 1);}\
+      sum(20000);",
+     Integer(59998)},
+    {"fn g() {return y;} fn f(y) {return g();} f(7);", Integer(7)},
+    {"fn g(x) {return x;} fn f(n) {let t = n + 1; return g(t);} f(5);",
+     Integer(6)},
+};
+
+TEST(TestEvaluator, testRecursion) {
+  for (const auto &[i, p] : RECURSION) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testRecursion) {
+  for (const auto &[i, p] : RECURSION) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+TEST(TestEvaluator, testRecursionLimit) {
+  const string input =
+      "fn sum(n) {if (n == 0) {return 0;} return 1 + sum(n - 1);} sum(100);";
+  Evaluator visitor;
+  visitor.setRecursionLimit(50);
+  EXPECT_THROW(evaluate(visitor, input), runtime_error);
+  visitor.rollback();
+  visitor.setRecursionLimit(101);
+  evaluate(visitor, input);
+  EXPECT_EQ(Integer(100), visitor.getResult().value);
+}
+
+// parameters without `mut` take constant arguments, whatever precedes them
+const map<string, ObjectValue> PARAMETERS{
+    {"fn apply(f, x) {return f(x);} let square = #(v) {return v * v;};\
+      let n = 7; apply(square, n);",
+     Integer(49)},
+    {"fn f(mut a, b, mut c, d) {a = b; c = d; return a + c;}\
+      let mut x = 0; let y = 2; let mut z = 0; let w = 3; f(x, y, z, w);",
+     Integer(5)},
+};
+
+TEST(TestEvaluator, testParameters) {
+  for (const auto &[i, p] : PARAMETERS) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testParameters) {
+  for (const auto &[i, p] : PARAMETERS) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// the right side runs only when the left one does not decide the result
+const string COUNTED = "let mut n = 0; fn bump(x) {n = n + 1; return x;}";
+
+const map<string, ObjectValue> SHORT_CIRCUIT{
+    {COUNTED + "false && bump(true); true || bump(true); n;", Integer(0)},
+    {COUNTED + "true && bump(true); false || bump(false); n;", Integer(2)},
+    {COUNTED + "false && bump(true) || bump(true);", true},
+    {COUNTED + "true && bump(false) || false;", false},
+    {"fn f(a) {return a && 1;} f(false);", false},
+    {"fn f(a) {return a || 1;} f(true);", true},
+    {"let x = 1; false && x;", false},
+};
+
+TEST(TestEvaluator, testShortCircuit) {
+  for (const auto &[i, p] : SHORT_CIRCUIT) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testShortCircuit) {
+  for (const auto &[i, p] : SHORT_CIRCUIT) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// operands which are not bools still fail when they are evaluated
+const vector<string> LOGICAL_ERRORS{
+    "1 && false;",
+    "true && 1;",
+    "false || 1;",
+    "1 || true;",
+};
+
+TEST(TestEvaluator, testLogicalErrors) {
+  for (const auto &i : LOGICAL_ERRORS) {
+    EXPECT_THROW(compareExpectedAndReceived(i, false), runtime_error);
+  }
+}
+
+TEST(TestVM, testLogicalErrors) {
+  for (const auto &i : LOGICAL_ERRORS) {
+    EXPECT_THROW(compareExpectedAndReceivedVM(i, false), runtime_error);
+  }
+}
+
+const string STAGES = "fn inc(x) {return x + 1;}\
+  fn dbl(x) {let y = x * 2; return y;}\
+  fn wide(x) {let a = x; let b = a + 1; let c = b + 1; return c;}\
+  fn sum(a, b) {return a + b;}";
+
+const map<string, ObjectValue> PIPELINES{
+    {STAGES + "let p = inc | dbl | inc; p(1);", Integer(5)},
+    {STAGES + "let p = sum | dbl; p(1, 2);", Integer(6)},
+    {STAGES + "let p = (inc | dbl) | (inc | wide); p(0);", Integer(5)},
+    // stages appended for `q` are not seen by `p`
+    {STAGES + "let p = inc | dbl; let q = p | p; let r = p | wide;\
+      q(1) * 100 + p(1) * 10 + r(0);",
+     Integer(1044)},
+    {STAGES + "fn f(mut x) {x = x + 1; return x;} let mut v = 1;\
+      let p = f | dbl; p(v) + v;",
+     Integer(6)},
+};
+
+TEST(TestEvaluator, testPipelines) {
+  for (const auto &[i, p] : PIPELINES) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testPipelines) {
+  for (const auto &[i, p] : PIPELINES) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// a lambda evaluated again shares its body with the previous functions
+const string NESTED = "fn f() {return #(x) {return x + 1;};}";
+
+TEST(TestEvaluator, testSharedBodies) {
+  Evaluator visitor;
+  evaluate(visitor, NESTED);
+  evaluate(visitor, "f();");
+  ObjectValue first = visitor.getResult().value;
+  evaluate(visitor, "f();");
+  ObjectValue second = visitor.getResult().value;
+  EXPECT_EQ(first.asFunction().stage(0).body,
+            second.asFunction().stage(0).body);
+}
+
+TEST(TestVM, testSharedBodies) {
+  Compiler compiler;
+  VM vm;
+  auto run = [&](const string &input) {
+    istringstream in(input);
+    Parser p(in);
+    vm.run(compiler.compile(*p.generateParsingTree()));
+    return vm.getResult().value;
+  };
+  run(NESTED);
+  ObjectValue first = run("f();");
+  ObjectValue second = run("f();");
+  EXPECT_EQ(first.asFunction().stage(0).body,
+            second.asFunction().stage(0).body);
+}
+
+// optimized programs give the results of the parsed ones
+const map<string, ObjectValue> OPTIMIZED{
+    {"let x = 4; (2 * 3) <- flt + x <- flt;", Float(10.0)},
+    {"fn f() {return 1 / 0;} \"a\" + 1 <- str <- str;", "a1"},
+    {"fn f() {5; ;} f();", ObjectValue()},
+    {"fn f(mut a) {a = a + 1;} let mut b = 1; f((b)); b;", Integer(2)},
+    {COUNTED + "(false && bump(true)) || (true || bump(true)); n;",
+     Integer(0)},
+};
+
+TEST(TestOptimizer, testEvaluator) {
+  for (const auto &[i, p] : OPTIMIZED) {
+    istringstream in(i);
+    Parser parser(in);
+    unique_ptr<Node> output = parser.generateParsingTree();
+    pheonix::optimizer::Optimizer().optimize(*output);
+    Evaluator visitor;
+    output->accept(visitor);
+    EXPECT_EQ(p, visitor.getResult().value);
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestOptimizer, testVM) {
+  for (const auto &[i, p] : OPTIMIZED) {
+    istringstream in(i);
+    Parser parser(in);
+    unique_ptr<Node> output = parser.generateParsingTree();
+    pheonix::optimizer::Optimizer().optimize(*output);
+    Compiler compiler;
+    VM vm;
+    vm.run(compiler.compile(*output));
+    EXPECT_EQ(p, vm.getResult().value);
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// one site sees more type pairs than its cache keeps
+const string POLYMORPHIC = "fn add(a, b) {return a + b;}\
+  let mut i = 0; let mut s = \"\";\
+  while (i < 10) {i = add(i, 1); s = add(s, \"a\"); add(1.5, 1.5);}\
+  s + (i <- str);";
+
+TEST(TestEvaluator, testInlineCache) {
+  auto before = cacheStats();
+  compareExpectedAndReceived(POLYMORPHIC, "aaaaaaaaaa10");
+  // `i < 10` misses only the first time, `a + b` every time
+  EXPECT_EQ(cacheStats().misses - before.misses, 32);
+  EXPECT_EQ(cacheStats().hits - before.hits, 10);
+}
+
+TEST(TestVM, testInlineCache) {
+  auto before = cacheStats();
+  compareExpectedAndReceivedVM(POLYMORPHIC, "aaaaaaaaaa10");
+  EXPECT_EQ(cacheStats().misses - before.misses, 32);
+  EXPECT_EQ(cacheStats().hits - before.hits, 10);
+}
+
+// results out of 64 bits, wrapped around and promoted to BigInt, the trap
+// policy throws for all of them
+struct Overflowed {
+  ObjectValue wrapped;
+  ObjectValue promoted;
+};
+const map<string, Overflowed> OVERFLOWS{
+    {"9223372036854775807 + 1;",
+     {Integer(INT64_MIN), BigInt::parse("9223372036854775808")}},
+    {"-9223372036854775807 - 2;",
+     {Integer(INT64_MAX), BigInt::parse("-9223372036854775809")}},
+    {"4294967296 * 4294967297;",
+     {Integer(4294967296), BigInt::parse("18446744078004518912")}},
+    {"let m = -9223372036854775807 - 1; m / -1;",
+     {Integer(INT64_MIN), BigInt::parse("9223372036854775808")}},
+    {"let m = -9223372036854775807 - 1; -m;",
+     {Integer(INT64_MIN), BigInt::parse("9223372036854775808")}},
+};
+
+// sets the overflow policy for the scope, promote is the default one
+struct ScopedPolicy {
+  ScopedPolicy(OverflowPolicy policy) { setOverflowPolicy(policy); }
+  ~ScopedPolicy() { setOverflowPolicy(OverflowPolicy::PROMOTE); }
+};
+
+TEST(TestEvaluator, testOverflow) {
+  for (const auto &[input, results] : OVERFLOWS) {
+    compareExpectedAndReceived(input, results.promoted);
+    {
+      ScopedPolicy trap(OverflowPolicy::TRAP);
+      EXPECT_THROW(compareExpectedAndReceived(input, false), runtime_error);
+    }
+    ScopedPolicy wrap(OverflowPolicy::WRAP);
+    compareExpectedAndReceived(input, results.wrapped);
+  }
+}
+
+TEST(TestVM, testOverflow) {
+  for (const auto &[input, results] : OVERFLOWS) {
+    compareExpectedAndReceivedVM(input, results.promoted);
+    {
+      ScopedPolicy trap(OverflowPolicy::TRAP);
+      EXPECT_THROW(compareExpectedAndReceivedVM(input, false), runtime_error);
+    }
+    ScopedPolicy wrap(OverflowPolicy::WRAP);
+    compareExpectedAndReceivedVM(input, results.wrapped);
+  }
+}
+
+// a of 64 limbs and b of 53, multiplied by Karatsuba
+const string KARATSUBA = "let mut a = 1; let mut b = 1; let mut i = 1;\
+  while (i <= 300) {\
+    a = a * i;\
+    if (i <= 250) { b = b * (i + 7); }\
+    i = i + 1;\
+  }";
+
+// ints out of 64 bits, results which fit are ints of 64 bits again
+const map<string, ObjectValue> BIGINTS{
+    {"let mut f = 1; let mut i = 1;\
+      while (i <= 30) { f = f * i; i = i + 1; }\
+      f;",
+     BigInt::parse("265252859812191058636308480000000")},
+    {"9223372036854775807 + 1 - 1;", Integer(INT64_MAX)},
+    {"-(9223372036854775807 + 1) == -9223372036854775807 - 1;", true},
+    {"9223372036854775807 + 1 > 9223372036854775807;", true},
+    {"(9223372036854775807 * 10 + 7) % 10;", Integer(7)},
+    {"(-9223372036854775807 * 10 - 7) / 10;", Integer(-9223372036854775807)},
+    {"(-9223372036854775807 * 10 - 7) % 10;", Integer(-7)},
+    {"(9223372036854775807 + 1) <- str;", "9223372036854775808"},
+    {"(9223372036854775807 * 2) <- flt;", Float(0x1p64)},
+    {"(9223372036854775807 + 1) <- bol;", true},
+    {"((9223372036854775807 <- flt) * 4.) <- int;",
+     BigInt::parse("36893488147419103232")},
+    {"9223372036854775808;", BigInt::parse("9223372036854775808")},
+    {"-9223372036854775808;", Integer(INT64_MIN)},
+    {"-9223372036854775808 - 1 + 1 == -9223372036854775808;", true},
+    {"99999999999999999999 - 99999999999999999998;", Integer(1)},
+    {KARATSUBA + "(a * b) / b == a;", true},
+    {KARATSUBA + "(a * b + 5) % b;", Integer(5)},
+};
+
+TEST(TestEvaluator, testBigInts) {
+  for (const auto &[i, p] : BIGINTS) {
+    compareExpectedAndReceived(i, p);
+  }
+}
+
+TEST(TestVM, testBigInts) {
+  for (const auto &[i, p] : BIGINTS) {
+    compareExpectedAndReceivedVM(i, p);
+  }
+}
+
+// (10^n - 1)^2 is n - 1 nines, an eight, n - 1 zeros and a one
+TEST(TestBigInt, testKaratsuba) {
+  size_t n = 1000;
+  BigInt nines = BigInt::parse(string(n, '9'));
+  string expected = string(n - 1, '9') + "8" + string(n - 1, '0') + "1";
+  EXPECT_EQ((nines * nines).str(), expected);
+  EXPECT_EQ((nines * nines) / nines, nines);
+  EXPECT_EQ((-nines * nines).str(), "-" + expected);
+}
+
+// errors raised while running are given the position of their statement
+const map<string, string> RUNTIME_ERRORS{
+    {"let a = 1;\na = 2;", "2:1: error: variable is not mutable."},
+    {"fn f(x) {\n  let y = x;\n  return y + \"a\";\n}\nf(1);",
+     "3:3: error: Invalid transition"},
+    {"let p = #(x) {return x;} | #(x) {\n  return -x * true;};\np(1);",
+     "2:3: error: Invalid transition"},
+    {"fn f(x) {x = 1;}\nlet a = 0;\n  f(a);",
+     "1:10: error: variable is not mutable."},
+    {"let a = 1;\nprint(y);", "2:1: error: Identifier not found: y"},
+    {"fn f(a) {\n  return a;\n}\nf(1, 2);",
+     "4:1: error: Wrong number of arguments."},
+    {"fn f(a, b) {return a;}\n\n[f](1);",
+     "3:1: error: Wrong number of arguments."},
+    {"fn f() {\n  return z + 1;\n}\nf();",
+     "2:3: error: Identifier not found: z"},
+};
+
+TEST(TestEvaluator, testRuntimeErrors) {
+  for (const auto &[input, message] : RUNTIME_ERRORS) {
+    Evaluator visitor;
+    try {
+      evaluate(visitor, input);
+      ADD_FAILURE() << input;
+    } catch (const RuntimeException &e) {
+      EXPECT_STREQ(e.what(), message.c_str());
+    }
+  }
+}
+
+TEST(TestVM, testRuntimeErrors) {
+  for (const auto &[input, message] : RUNTIME_ERRORS) {
+    try {
+      compareExpectedAndReceivedVM(input, false);
+      ADD_FAILURE() << input;
+    } catch (const RuntimeException &e) {
+      EXPECT_STREQ(e.what(), message.c_str());
+    }
+  }
+}
+
+// a VM which failed in calls runs the next program from the global frame,
+// the frames the calls left would exceed the recursion limit
+TEST(TestVM, testRunAfterError) {
+  Compiler compiler;
+  VM vm;
+  vm.setRecursionLimit(8);
+  auto run = [&](const string &input) {
+    istringstream in(input);
+    Parser p(in);
+    vm.run(compiler.compile(*p.generateParsingTree()));
+  };
+  run("fn f(n) {if (n == 0) {return 0;} return 1 + f(n - 1);}");
+  EXPECT_THROW(run("f(100);"), RuntimeException);
+  run("f(7);");
+  EXPECT_EQ(vm.getResult().value, ObjectValue(Integer(7)));
+}
+
+// lines matter here, one declaration per line
+const string PROFILED = "fn inc(x) {return x + 1;}\n\
+fn loop(n) {if (n == 0) {return 0;} return loop(n - 1);}\n\
+let add2 = inc | #(x) {return x + 1;};\n\
+let mut i = 0;\n\
+while (i < 5) {i = inc(i);}\n\
+add2(i);\n\
+loop(3);";
+
+TEST(TestEvaluator, testProfile) {
+  profile::Profiler profiler;
+  Evaluator visitor;
+  visitor.setProfiler(&profiler);
+  profiler.start();
+  evaluate(visitor, PROFILED);
+  profiler.stop();
+  EXPECT_EQ(visitor.getResult().value, ObjectValue(Integer(0)));
+  EXPECT_EQ(profiler.calls(symbol::intern("main"), 0), 1);
+  EXPECT_EQ(profiler.calls(symbol::intern("inc"), 1), 6);
+  // tail calls and pipeline stages count as calls too
+  EXPECT_EQ(profiler.calls(symbol::intern("loop"), 2), 4);
+  EXPECT_EQ(profiler.calls(symbol::intern("lambda"), 3), 1);
+  ostringstream folded;
+  profiler.folded(folded);
+  string line;
+  istringstream stacks(folded.str());
+  while (getline(stacks, line))
+    EXPECT_TRUE(line.starts_with("main:")) << line;
+}
+
+// the clock ticks a millisecond per reading and every statement, call and
+// return takes a sample, so each sample charges one tick
+const string TICKED = "fn square(v) {\n\
+  return v * v;\n\
+}\n\
+let x = 3;\n\
+let y = square(x);\n\
+let z = x;";
+
+TEST(TestEvaluator, testProfileLines) {
+  using std::chrono::milliseconds;
+  std::chrono::steady_clock::time_point now;
+  profile::Profiler profiler(std::chrono::microseconds(0),
+                             [&now] { return now += milliseconds(1); });
+  Evaluator visitor;
+  visitor.setProfiler(&profiler);
+  profiler.start();
+  evaluate(visitor, TICKED);
+  profiler.stop();
+  // the last statement of a call is charged to it, not to the call site,
+  // which gets its arguments and the return to it
+  EXPECT_EQ(profiler.self(2), milliseconds(1));
+  EXPECT_EQ(profiler.self(5), milliseconds(2));
+  EXPECT_EQ(profiler.self(6), milliseconds(1));
+  ostringstream folded;
+  profiler.folded(folded);
+  EXPECT_NE(folded.str().find("main:5;square:2 1000\n"), string::npos)
+      << folded.str();
+}
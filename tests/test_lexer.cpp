@@ -1,4 +1,5 @@
 #include "lexer.hpp"
+#include "scan.hpp"
 #include "types.hpp"
 
 #include <cassert>
@@ -286,6 +287,13 @@ const map<const string, const Token> INTEGERS{
     {"21323234", Token(TokenType::INTEGER, 21323234)},
     {to_string(numeric_limits<int>::max()),
      Token(TokenType::INTEGER, numeric_limits<int>::max())},
+    {to_string(numeric_limits<int64_t>::max()),
+     Token(TokenType::INTEGER, numeric_limits<int64_t>::max())},
+    // out of 64 bits under the PROMOTE policy
+    {"9223372036854775808",
+     Token(TokenType::INTEGER, BigInt::parse("9223372036854775808"))},
+    {"99999999999999999999",
+     Token(TokenType::INTEGER, BigInt::parse("99999999999999999999"))},
 };
 TEST(TestLexer, testIntegers) {
   for (const auto &[key, value] : INTEGERS) {
@@ -302,12 +310,13 @@ TEST(TestLexer, testIntegers) {
     compareLexemVectors(expected, result);
   }
 }
-// TODO: make errors of integers and floats mention lines
 const map<const string, const string> INTEGERS_ERRORS{
-    {to_string(static_cast<long>(numeric_limits<int>::max()) + 1),
-     "Integer literal out of range."},
-    {to_string(2 * static_cast<long>(numeric_limits<int>::max())),
-     "Integer literal out of range."},
+    {to_string(static_cast<uint64_t>(numeric_limits<int64_t>::max()) + 1),
+     "1:1: error: Integer literal out of range."},
+    {to_string(2 * static_cast<uint64_t>(numeric_limits<int64_t>::max())),
+     "1:1: error: Integer literal out of range."},
+    {"let a = 99999999999999999999;",
+     "1:9: error: Integer literal out of range."},
     // {
     //     to_string(21321) + "a",
     //     "Undefined value."
@@ -315,19 +324,21 @@ const map<const string, const string> INTEGERS_ERRORS{
 };
 
 TEST(TestLexer, testIntegersErrors) {
+  setOverflowPolicy(OverflowPolicy::TRAP);
   for (const auto &[key, value] : INTEGERS_ERRORS) {
     string input = key;
     istringstream in(input);
     Lexer l(in);
     try {
       lexerize(l);
-      FAIL() << "Expected runtime_error";
-    } catch (const runtime_error &e) {
+      FAIL() << "Expected LexerException";
+    } catch (const LexerException &e) {
       EXPECT_STREQ(e.what(), value.c_str());
     } catch (...) {
       FAIL() << "Unexpected exception type thrown";
     }
   }
+  setOverflowPolicy(OverflowPolicy::PROMOTE);
 }
 
 const map<const string, const Token> FLOATS{
@@ -339,6 +350,8 @@ const map<const string, const Token> FLOATS{
     {"13.12", Token(TokenType::FLOAT, stod("13.12"))},
     {"213.", Token(TokenType::FLOAT, stod("213."))},
     {"213.11111", Token(TokenType::FLOAT, stod("213.11111"))},
+    {"99999999999999999999.5",
+     Token(TokenType::FLOAT, stod("99999999999999999999.5"))},
 };
 
 TEST(TestLexer, testFloats) {
@@ -971,3 +984,53 @@ let mut b = 123<-str;
 
   compareLexemVectors(expected, result);
 }
+
+// every scanning kernel gives the same lexems as the scalar one
+const vector<string> SCAN_INPUTS{
+    "let " + string(40, 'a') + "_1 =\t\t" + string(70, ' ') + "b;",
+    "// " + string(100, 'c') + "\n" + string(33, 'x') + "\r\n//",
+    "/* " + string(50, '-') + " ** x\n" + string(31, 'y') + " */ z",
+    "/* " + string(64, 'q') + "\r\n   " + string(17, '*') + "/",
+    string(45, 'i') + "\xc3\xb3" + string(20, 'j'),
+    "/* " + string(40, 'k') + "\xff" + " */",
+};
+
+TEST(TestLexer, testScanKernels) {
+  auto lexerizeWith = [](scan::Isa isa, const string &input) {
+    scan::use(isa);
+    Lexer l{string_view(input)};
+    vector<Lexem> result;
+    try {
+      result = lexerize(l);
+    } catch (const LexerException &e) {
+      result.push_back({Token(TokenType::NOT_A_TOKEN, e.what()), 0, 0});
+    }
+    return result;
+  };
+  auto previous = scan::current();
+  for (const auto &input : SCAN_INPUTS) {
+    auto expected = lexerizeWith(scan::Isa::SCALAR, input);
+    for (auto isa : {scan::Isa::SSE2, scan::Isa::AVX2}) {
+      if (scan::supported(isa))
+        compareLexemVectors(expected, lexerizeWith(isa, input));
+    }
+  }
+  scan::use(previous);
+}
+
+// a stream is lexed through a window, the refills fall at every `offset`
+// before the lexems, in them or between them
+const string WINDOWED = "\"" + string(1000, 's') + "\" /*" +
+                        string(1000, 'c') + "\n*/ // " + string(1000, 'l') +
+                        "\r\nlet " + string(1000, 'i') +
+                        " = 123456789012345678901234567890;\n";
+
+TEST(TestLexer, testStreamWindow) {
+  for (size_t offset : {1, 2, 3, 500, 1003, 2010, 3019, 3500, 4030, 4097}) {
+    string input = string(WINDOW - offset, ' ') + WINDOWED + WINDOWED;
+    Lexer inPlace{string_view(input)};
+    istringstream in(input);
+    Lexer streamed(in);
+    compareLexemVectors(lexerize(inPlace), lexerize(streamed));
+  }
+}
@@ -1,4 +1,5 @@
 #include "ast_view.hpp"
+#include "optimizer.hpp"
 #include "parser.hpp"
 
 #include <gtest/gtest.h>
@@ -1699,6 +1700,111 @@ TEST(TestParser, some_from_documentation) {
     compareExpectedAndReceived(i, e);
   }
 }
+///////////////////////////////////////////////////////////////////////////////
+void compareOptimized(const string &input, const string &expected) {
+  istringstream in(input);
+  Parser p(in);
+  unique_ptr<Node> output = p.generateParsingTree();
+  pheonix::optimizer::Optimizer().optimize(*output);
+  ASTView visitor;
+  output->accept(visitor);
+  EXPECT_EQ(expected, visitor.getResult());
+}
+
+const map<string, string> OPTIMIZED{
+    {"-2 + 12 * (3 - 1);", "(Program:\n\
+    (ExpressionStatement:\n\
+        expression=(Literal:\n\
+            type=Integer,\n\
+            value=22)))"},
+    // the last null statement is kept
+    {"x <- int <- int; ; 1; ;", "(Program:\n\
+    (ExpressionStatement:\n\
+        expression=(CastExpression:\n\
+            expression=(Identifier:\n\
+                value=x),\n\
+            type=(TypeSpecifier:\n\
+                value=INT))),\n\
+    (ExpressionStatement:\n\
+        expression=(Literal:\n\
+            type=Integer,\n\
+            value=1)),\n\
+    (NullStatement:))"},
+    // errors are left to the evaluation
+    {"\"a\" + 1 <- str; 1 / 0;", "(Program:\n\
+    (ExpressionStatement:\n\
+        expression=(Literal:\n\
+            type=String,\n\
+            value=a1)),\n\
+    (ExpressionStatement:\n\
+        expression=(MultiplicativeExpression:\n\
+            left=(Literal:\n\
+                type=Integer,\n\
+                value=1),\n\
+            operator=[/],\n\
+            right=(Literal:\n\
+                type=Integer,\n\
+                value=0))))"},
+};
+
+TEST(TestOptimizer, testOptimized) {
+  for (const auto &[i, e] : OPTIMIZED) {
+    compareOptimized(i, e);
+  }
+}
+// "line:column-line:column" of the node in the spans of the program
+string spanOf(const Program &program, const Node &node) {
+  const Span *span = program.spans->find(node.id);
+  if (!span)
+    return "none";
+  ostringstream out;
+  out << span->begin << "-" << span->end;
+  return out.str();
+}
+
+TEST(TestParser, testSpans) {
+  istringstream in("let a = 1 + 22;\nwhile (a) {\n  f(a); // call\n}");
+  Parser p(in);
+  unique_ptr<Node> output = p.generateParsingTree();
+  auto &program = dynamic_cast<Program &>(*output);
+  auto &declaration =
+      dynamic_cast<VariableDeclaration &>(*program.statements[0]);
+  auto &sum = dynamic_cast<AdditiveExpression &>(*declaration.expression);
+  auto &loop = dynamic_cast<WhileLoopStatement &>(*program.statements[1]);
+  auto &body = dynamic_cast<Block &>(*loop.statements);
+  auto &call = dynamic_cast<ExpressionStatement &>(*body.statements[0]);
+  EXPECT_EQ(spanOf(program, declaration), "1:1-1:16");
+  EXPECT_EQ(spanOf(program, sum), "1:9-1:15");
+  EXPECT_EQ(spanOf(program, *sum.right), "1:13-1:15");
+  EXPECT_EQ(spanOf(program, loop), "2:1-4:2");
+  EXPECT_EQ(spanOf(program, body), "2:11-4:2");
+  EXPECT_EQ(spanOf(program, call), "3:3-3:8");
+  EXPECT_EQ(spanOf(program, *call.expression), "3:3-3:7");
+  // clones keep the spans, nodes made by the optimizer take them over
+  EXPECT_EQ(spanOf(program, *loop.clone()), "2:1-4:2");
+  pheonix::optimizer::Optimizer().optimize(program);
+  EXPECT_EQ(spanOf(program, *declaration.expression), "1:9-1:15");
+}
+
+TEST(TestParser, testStreaming) {
+  istringstream in("let a = 1;\nfn f(x) {\n  return x;\n}\nf(a); ) ;");
+  Parser p(in);
+  vector<string> spans;
+  for (int i = 0; i < 3; ++i) {
+    auto output = p.parse();
+    ASSERT_TRUE(output);
+    auto &program = dynamic_cast<Program &>(**output);
+    ASSERT_EQ(program.statements.size(), 1);
+    spans.push_back(spanOf(program, *program.statements[0]));
+  }
+  EXPECT_EQ(spans, vector<string>({"1:1-1:11", "2:1-4:2", "5:1-5:6"}));
+  // the error is only seen when the statement after the last one is parsed
+  EXPECT_THROW(p.parse(), ParserException);
+
+  istringstream empty("  // nothing\n");
+  EXPECT_FALSE(Parser(empty).parse());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // testing errors
 